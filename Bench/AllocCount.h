@@ -0,0 +1,9 @@
+#pragma once
+
+// Heap allocations made so far. Linking AllocCount.cpp replaces the global operator new
+// for the whole executable, so only SnakeAllocBench does; SnakeBench keeps the default
+// allocator its numbers are meant to reflect.
+
+#include <cstddef>
+
+size_t allocationCount();
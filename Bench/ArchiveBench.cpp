@@ -0,0 +1,61 @@
+#include "BenchUtil.h"
+#include "ReplayArchive.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <filesystem>
+
+static const size_t kArchiveGames = 20000;
+
+// built once per process in the temp directory
+static const std::string& archivePath() {
+	static std::string path = [] {
+		std::string p = (std::filesystem::temp_directory_path() / "SnakeBench.snka").string();
+		std::filesystem::remove(p);
+		ReplayArchiveWriter writer(p);
+		for (size_t i = 0; i < kArchiveGames; i++) {
+			GameSim sim(20, 20, ParallelRunner::episodeSeed(7, i));
+			ReplayRecorder rec;
+			rec.begin(sim);
+			while (!sim.isOver()) {
+				sim.step(greedyPolicy(sim));
+				rec.onStep(sim);
+			}
+			writer.append(rec.finish(sim));
+		}
+		return p;
+	}();
+	return path;
+}
+
+// index-only filter over the mapped footer
+static void BM_ArchiveFilter(benchmark::State& state) {
+	ReplayArchive archive(archivePath());
+	ReplayArchive::Filter filter;
+	filter.minScore = 5;
+	for (auto _ : state) {
+		auto hits = archive.select(filter);
+		benchmark::DoNotOptimize(hits.data());
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(archive.count()));
+}
+BENCHMARK(BM_ArchiveFilter);
+
+// decode and re-simulate every episode in parallel
+static void BM_ArchiveReplayAll(benchmark::State& state) {
+	ReplayArchive archive(archivePath());
+	ParallelRunner runner(static_cast<unsigned>(state.range(0)));
+	ReplayArchive::Filter all;
+	for (auto _ : state) {
+		std::atomic<uint64_t> ticks{ 0 };
+		archive.forEach(runner, all, [&](size_t i, const ArchiveEntry&, const uint8_t*, unsigned) {
+			Replay r;
+			archive.decode(i, r);
+			ReplayPlayer p(r, UINT64_MAX);
+			while (p.stepForward()) { }
+			ticks += p.tick();
+		});
+		benchmark::DoNotOptimize(ticks.load());
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(archive.count()));
+}
+BENCHMARK(BM_ArchiveReplayAll)->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
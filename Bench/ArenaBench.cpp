@@ -0,0 +1,56 @@
+#include "ArenaSim.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+// Arena ticks with every snake steered by a cheap local rule (straight on, else a free side,
+// now and then a random turn), the rule included in the timing as a server would run it.
+// Baits at one per two snakes, dead snakes respawn. The target is 10k snakes on 2048 x 2048
+// at 60 ticks a second: ticks_per_second / 60 is the headroom.
+static void steer(const ArenaSim& arena, Rng& rng, std::vector<Action>& actions) {
+	for (size_t i = 0; i < arena.nSnakes(); i++) {
+		actions[i] = Action::None;
+		if (!arena.isAlive(i)) continue;
+		const Cell h = arena.getHead(i);
+		uint32_t d0 = static_cast<uint32_t>(arena.direction(i));
+		if ((rng.next32() & 15) == 0) d0 = rng.below(4);
+		static const uint32_t kTurns[4] = { 0, 1, 3, 2 }; // ahead, right, left, back
+		for (uint32_t turn : kTurns) {
+			const Direction d = static_cast<Direction>((d0 + turn) & 3);
+			if (arena.isOppositeDirection(i, d)) continue;
+			const Cell v = directionAsVector(d);
+			if (arena.isFree(Cell{ h.x + v.x, h.y + v.y })) { actions[i] = static_cast<Action>(d); break; }
+		}
+	}
+}
+
+static void BM_ArenaTick(benchmark::State& state) {
+	ArenaConfig config;
+	config.width = config.height = static_cast<int>(state.range(0));
+	config.nSnakes = static_cast<uint32_t>(state.range(1));
+	config.nBaits = config.nSnakes / 2;
+	config.seed = 1;
+	ArenaSim arena(config);
+	Rng rng(2);
+	std::vector<Action> actions(arena.nSnakes(), Action::None);
+	for (int t = 0; t < 200; t++) { // past the spawn, snakes at their usual length
+		steer(arena, rng, actions);
+		arena.step(actions.data());
+	}
+
+	uint64_t moved = 0;
+	uint64_t died = 0;
+	for (auto _ : state) {
+		steer(arena, rng, actions);
+		arena.step(actions.data());
+		const ArenaSim::TickStats& s = arena.lastTick();
+		moved += s.moved;
+		died += s.diedWall + s.diedBody + s.diedHeadOn;
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(moved)); // heads moved
+	state.counters["ticks_per_second"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+	state.counters["deaths/tick"] = static_cast<double>(died) / static_cast<double>(state.iterations());
+	state.counters["MB"] = static_cast<double>(arena.memoryBytes()) / (1 << 20);
+}
+BENCHMARK(BM_ArenaTick)->ArgNames({ "side", "snakes" })
+	->Args({ 256, 100 })->Args({ 1024, 2000 })->Args({ 2048, 10000 })->Args({ 2048, 50000 })
+	->Unit(benchmark::kMicrosecond);
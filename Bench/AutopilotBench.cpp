@@ -0,0 +1,33 @@
+#include "Autopilot.h"
+#include "BenchUtil.h"
+#include <benchmark/benchmark.h>
+
+// whole games driven by the autopilot on a side x side board; items are decisions (each
+// followed by its tick), avg_score the mean bait eaten per finished game
+static void BM_Autopilot(benchmark::State& state) {
+	const int side = static_cast<int>(state.range(0));
+	GameSim sim(side, side, 1);
+	Autopilot pilot;
+	uint64_t games = 0;
+	uint64_t scoreSum = 0;
+	uint64_t won = 0;
+
+	for (auto _ : state) {
+		if (sim.isOver()) {
+			games++;
+			scoreSum += static_cast<uint64_t>(sim.score());
+			won += sim.isWon() ? 1 : 0;
+			sim.reset(sim.seed() + 1);
+		}
+		StepResult r = sim.step(pilot.decide(sim));
+		benchmark::DoNotOptimize(r);
+	}
+	const Autopilot::Stats& st = pilot.stats();
+	state.SetItemsProcessed(static_cast<int64_t>(st.decisions));
+	state.counters["decisions/s"] = benchmark::Counter(static_cast<double>(st.decisions), benchmark::Counter::kIsRate);
+	state.counters["games"] = static_cast<double>(games);
+	state.counters["avg_score"] = games ? static_cast<double>(scoreSum) / static_cast<double>(games) : static_cast<double>(sim.score());
+	state.counters["won"] = static_cast<double>(won);
+	state.counters["fallback%"] = st.decisions ? 100.0 * static_cast<double>(st.chaseTail + st.openArea) / static_cast<double>(st.decisions) : 0.0;
+}
+BENCHMARK(BM_Autopilot)->ArgName("side")->Arg(20)->Arg(40);
@@ -0,0 +1,25 @@
+#include "BatchedSnakeEnv.h"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+// env-steps/sec on a 20x20 board with random (non-reversing) actions; games auto-reset.
+static void BM_BatchedEnvStep(benchmark::State& state) {
+	size_t nGames = static_cast<size_t>(state.range(0));
+	BatchedSnakeEnv env(nGames, 20, 20, 1);
+
+	const size_t nBatches = 64;
+	std::vector<Action> actions(nGames * nBatches);
+	std::mt19937 rng(7);
+	for (auto& a : actions) a = static_cast<Action>(rng() % 5);
+
+	size_t b = 0;
+	for (auto _ : state) {
+		env.step(&actions[b * nGames]);
+		benchmark::DoNotOptimize(env.rewards());
+		b = (b + 1) % nBatches;
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(nGames));
+	state.counters["episodes"] = static_cast<double>(env.totalEpisodes());
+}
+BENCHMARK(BM_BatchedEnvStep)->Arg(256)->Arg(4096)->Arg(65536);
@@ -0,0 +1,92 @@
+#pragma once
+
+// Helpers shared by the benchmarks: lay a snake of a given length out on a SerpentinePath or
+// a CycleTour and keep driving it along that path, so long snakes can be measured without dying.
+
+#include "GameSim.h"
+#include "SerpentinePath.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+// Heads for the bait, turning away from walls and its own body when it can; episodes
+// end anywhere from a few ticks to a few thousand, which is what stealing is for.
+inline Action greedyPolicy(const GameSim& sim) {
+	const Snake& s = sim.getSnake();
+	Cell h = s.getHead();
+	Cell b = sim.getBait().getPos();
+	Direction want = b.x > h.x ? Direction::E : b.x < h.x ? Direction::W : b.y > h.y ? Direction::S : Direction::N;
+
+	for (int k = 0; k < 4; k++) {
+		Direction d = static_cast<Direction>((static_cast<int>(want) + k) % 4);
+		if (s.isOppositeDirection(d)) continue;
+		Cell v = directionAsVector(d);
+		if (sim.isValidBait(Cell{ h.x + v.x, h.y + v.y })) return static_cast<Action>(d);
+	}
+	return Action::None;
+}
+
+// Closed tour of an even-sided board: row 0 left to right, rows 1.. serpentine over
+// columns 1.., then back up column 0. A snake shorter than the board can follow it
+// forever, so the hot paths can be timed on huge boards without ever re-laying it out.
+// Computed from the index, no per-cell table (a 4096 x 4096 board has 16M cells).
+struct CycleTour {
+	int side = 0;
+
+	explicit CycleTour(int side_) : side(side_) { }
+
+	size_t size() const { return static_cast<size_t>(side) * static_cast<size_t>(side); }
+
+	Cell cellAt(size_t i) const {
+		i %= size();
+		const size_t s = static_cast<size_t>(side);
+		if (i < s) return Cell{ static_cast<int>(i), 0 };
+		size_t j = i - s;
+		const size_t w = s - 1;
+		if (j < w * w) {
+			int y = 1 + static_cast<int>(j / w);
+			int k = static_cast<int>(j % w);
+			return Cell{ (y % 2 == 1) ? side - 1 - k : 1 + k, y };
+		}
+		return Cell{ 0, side - 1 - static_cast<int>(j - w * w) };
+	}
+
+	Action actionAt(size_t i) const {
+		Cell a = cellAt(i);
+		Cell b = cellAt(i + 1);
+		if (b.x > a.x) return Action::E;
+		if (b.x < a.x) return Action::W;
+		return b.y > a.y ? Action::S : Action::N;
+	}
+
+	// actionAt() for one lap, for loops that should not time the index arithmetic
+	std::vector<Action> actions() const {
+		std::vector<Action> a(size());
+		for (size_t i = 0; i < a.size(); i++) a[i] = actionAt(i);
+		return a;
+	}
+
+	// snake on tour cells [0, length), head on length - 1; returns the head's tour index
+	size_t layout(GameSim& sim, size_t length) const {
+		std::vector<Cell> body(length);
+		for (size_t i = 0; i < length; i++) body[i] = cellAt(length - 1 - i);
+		sim.setSnakeBody(body, static_cast<Direction>(actionAt(length - 1)));
+		return length - 1;
+	}
+};
+
+// (side, length) pairs from 20 x 20 to 4096 x 4096, snakes up to half the board
+inline std::vector<std::vector<int64_t>> boardAndLengths() {
+	std::vector<std::vector<int64_t>> args;
+	for (int64_t side : { 20, 256, 4096 }) {
+		for (int64_t length : { 3, 100, 4096, 1 << 20, 1 << 23 }) {
+			if (length <= side * side / 2) args.push_back({ side, length });
+		}
+	}
+	return args;
+}
+
+inline void boardAndLengthArgs(benchmark::internal::Benchmark* b) {
+	b->ArgNames({ "side", "length" });
+	for (const std::vector<int64_t>& a : boardAndLengths()) b->Args(a);
+}
@@ -0,0 +1,37 @@
+#include "BenchUtil.h"
+#include <benchmark/benchmark.h>
+
+// Head-vs-body/wall check for the next tick: a single occupancy bit whatever the length.
+static void BM_HeadCollisionCheck(benchmark::State& state) {
+	size_t length = static_cast<size_t>(state.range(0));
+	int side = SerpentinePath::sideFor(length);
+	SerpentinePath path(side, side);
+	GameSim sim(side, side, 1);
+	path.layout(sim, length);
+
+	for (auto _ : state) {
+		bool hit = sim.getGrid().test(sim.getSnake().getNextPos());
+		benchmark::DoNotOptimize(hit);
+	}
+}
+BENCHMARK(BM_HeadCollisionCheck)->RangeMultiplier(10)->Range(3, 100000);
+
+// Full tick (move + collision + bait) while the snake walks the serpentine path.
+static void BM_Tick(benchmark::State& state) {
+	size_t length = static_cast<size_t>(state.range(0));
+	int side = SerpentinePath::sideFor(length);
+	SerpentinePath path(side, side);
+	GameSim sim(side, side, 1);
+	size_t head = path.layout(sim, length);
+
+	for (auto _ : state) {
+		if (head + 1 >= path.cells.size() || sim.isOver()) {
+			state.PauseTiming();
+			head = path.layout(sim, length);
+			state.ResumeTiming();
+		}
+		StepResult r = sim.step(path.actionAt(head++));
+		benchmark::DoNotOptimize(r);
+	}
+}
+BENCHMARK(BM_Tick)->RangeMultiplier(10)->Range(3, 100000);
@@ -0,0 +1,38 @@
+#include "HamiltonCycle.h"
+#include <benchmark/benchmark.h>
+
+// whole games on a side x side board driven by CyclePilot until the board is full; time is
+// per filled board, ticks_to_fill the mean ticks it took
+static void BM_CycleFill(benchmark::State& state) {
+	const int side = static_cast<int>(state.range(0));
+	const CyclePilot pilot(HamiltonCycle::forBoard(side, side));
+	GameSim sim(side, side, 1);
+	uint64_t ticks = 0;
+	uint64_t won = 0;
+
+	for (auto _ : state) {
+		state.PauseTiming();
+		sim.reset(sim.seed() + 1);
+		state.ResumeTiming();
+		while (!sim.isOver()) sim.step(pilot.decide(sim));
+		ticks += sim.ticks();
+		won += sim.isWon() ? 1 : 0;
+	}
+	const double n = static_cast<double>(state.iterations());
+	state.counters["ticks_to_fill"] = static_cast<double>(ticks) / n;
+	state.counters["won%"] = 100.0 * static_cast<double>(won) / n;
+	state.counters["ticks/s"] = benchmark::Counter(static_cast<double>(ticks), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_CycleFill)->ArgName("side")->Arg(10)->Arg(20)->Arg(32)->Arg(64)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CycleFill)->ArgName("side")->Arg(128)->Arg(256)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+// building the tour, once per board size
+static void BM_CycleBuild(benchmark::State& state) {
+	const int side = static_cast<int>(state.range(0));
+	for (auto _ : state) {
+		HamiltonCycle cycle(side, side);
+		benchmark::DoNotOptimize(cycle);
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * side * side);
+}
+BENCHMARK(BM_CycleBuild)->ArgName("side")->Arg(20)->Arg(256);
@@ -0,0 +1,85 @@
+#include "LargeBoardSim.h"
+#include "OccupancyGrid.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+// heads for the bait, turning away from anything occupied
+static Action chaseBait(const LargeBoardSim& sim) {
+	Cell h = sim.getHead();
+	Cell b = sim.getBait();
+	Direction want = b.x > h.x ? Direction::E : b.x < h.x ? Direction::W : b.y > h.y ? Direction::S : Direction::N;
+	for (int k = 0; k < 4; k++) {
+		Direction d = static_cast<Direction>((static_cast<int>(want) + k) % 4);
+		if (d == oppositeDirection(sim.direction())) continue;
+		Cell v = directionAsVector(d);
+		if (sim.isFree(Cell{ h.x + v.x, h.y + v.y })) return static_cast<Action>(d);
+	}
+	return Action::None;
+}
+
+// snake of `length` folded into a band 1000 cells wide below the start cell, head at the
+// end of the last row facing out of the band
+static void layoutBand(LargeBoardSim& sim, size_t length) {
+	const int band = 1000;
+	Cell s = sim.startCell();
+	std::vector<Cell> body(length);
+	for (size_t i = 0; i < length; i++) {
+		int row = static_cast<int>(i / band);
+		int k = static_cast<int>(i % band);
+		body[length - 1 - i] = Cell{ s.x + (row % 2 == 0 ? k : band - 1 - k), s.y + row };
+	}
+	int lastRow = static_cast<int>((length - 1) / band);
+	sim.setSnakeBody(body, lastRow % 2 == 0 ? Direction::E : Direction::W);
+}
+
+// ticks on a 100k x 100k board (10^10 cells); bytes follows the snake, not the board
+static void BM_LargeBoardStep(benchmark::State& state) {
+	const size_t length = static_cast<size_t>(state.range(0));
+	LargeBoardSim sim(100000, 100000, 7);
+	layoutBand(sim, length);
+
+	for (auto _ : state) {
+		if (sim.isOver()) {
+			state.PauseTiming();
+			sim.reset(sim.seed() + 1);
+			layoutBand(sim, length);
+			state.ResumeTiming();
+		}
+		StepResult r = sim.step(chaseBait(sim));
+		benchmark::DoNotOptimize(r);
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+	state.counters["bytes"] = static_cast<double>(sim.memoryBytes());
+	state.counters["tiles"] = static_cast<double>(sim.getGrid().nTiles());
+	state.counters["length"] = static_cast<double>(sim.length());
+}
+BENCHMARK(BM_LargeBoardStep)->ArgName("length")->Arg(3)->Arg(10000)->Arg(1000000);
+
+// head collision bit on the sparse grid vs the dense one, 4096 x 4096 with a snake-like
+// band of set cells; the sparse grid pays one hash probe
+template<class Grid>
+static void collisionBench(benchmark::State& state, Grid& grid) {
+	const int side = 4096;
+	for (int y = 0; y < 16; y++) {
+		for (int x = 0; x < side; x++) grid.testAndSet(Cell{ x, side / 2 + y });
+	}
+	uint32_t i = 0;
+	for (auto _ : state) {
+		i = i * 1664525u + 1013904223u;
+		Cell c{ static_cast<int>(i >> 20), side / 2 - 8 + static_cast<int>((i >> 4) & 31) };
+		benchmark::DoNotOptimize(grid.test(c));
+	}
+}
+
+static void BM_CollisionDense(benchmark::State& state) {
+	OccupancyGrid grid(4096, 4096);
+	collisionBench(state, grid);
+}
+BENCHMARK(BM_CollisionDense);
+
+static void BM_CollisionSparse(benchmark::State& state) {
+	SparseGrid grid(4096, 4096);
+	collisionBench(state, grid);
+	state.counters["bytes"] = static_cast<double>(grid.memoryBytes());
+}
+BENCHMARK(BM_CollisionSparse);
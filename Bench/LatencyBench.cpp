@@ -0,0 +1,34 @@
+#include "LatencyStats.h"
+#include <benchmark/benchmark.h>
+
+// one sample into the calling thread's histogram: the cost each instrumented point pays
+// (key, tick and paint, i.e. a few per frame); threads:4 checks the slots do not contend
+static void BM_LatencyRecord(benchmark::State& state) {
+	static LatencyStats stats;
+	if (state.thread_index() == 0) stats.reset();
+	LatencyStats::Clock::duration d = std::chrono::microseconds(100 + state.thread_index());
+	for (auto _ : state) {
+		stats.record(LatencyStage::InputToPaint, d);
+		d += std::chrono::nanoseconds(977);
+		if (d > std::chrono::milliseconds(50)) d = std::chrono::microseconds(100);
+	}
+	if (state.thread_index() == 0) {
+		LatencySummary s = stats.summary(LatencyStage::InputToPaint);
+		state.counters["p50_us"] = static_cast<double>(s.p50Ns) / 1e3;
+		state.counters["p99_us"] = static_cast<double>(s.p99Ns) / 1e3;
+	}
+}
+BENCHMARK(BM_LatencyRecord)->Threads(1)->Threads(4);
+
+// merging the per-thread histograms into p50 / p99 / max, what the UI bar readout costs per frame
+static void BM_LatencySummary(benchmark::State& state) {
+	static LatencyStats stats;
+	for (int i = 0; i < 10000; i++) stats.record(LatencyStage::InputToPaint, std::chrono::microseconds(i));
+	char buff[32];
+	for (auto _ : state) {
+		stats.formatShort(buff, sizeof(buff));
+		benchmark::DoNotOptimize(buff);
+	}
+	state.SetLabel(buff);
+}
+BENCHMARK(BM_LatencySummary);
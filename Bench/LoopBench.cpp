@@ -0,0 +1,72 @@
+#include "BenchUtil.h"
+#include "FixedStep.h"
+#include "InputQueue.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <thread>
+
+// the game loop with the clock unthrottled: greedy games back to back, ticks/s is the
+// simulation rate the front end's "U" mode gets (the frame slice included)
+static void BM_LoopUnthrottled(benchmark::State& state) {
+	const int side = static_cast<int>(state.range(0));
+	GameSim sim(side, side, 7);
+	FixedStep clock;
+	clock.setUnthrottled(true);
+	clock.reset(FixedStep::Clock::now());
+	const std::chrono::milliseconds step(sim.getSnake().getSpeed());
+
+	uint64_t ticks = 0;
+	for (auto _ : state) {
+		clock.beginFrame(FixedStep::Clock::now());
+		while (clock.tick(step)) {
+			sim.step(greedyPolicy(sim));
+			if (sim.isOver()) sim.reset(sim.seed() + 1);
+		}
+		ticks += static_cast<uint64_t>(clock.frameTicks());
+	}
+	state.counters["ticks/s"] = benchmark::Counter(static_cast<double>(ticks), benchmark::Counter::kIsRate);
+	state.counters["ticks/frame"] = static_cast<double>(ticks) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_LoopUnthrottled)->ArgName("side")->Arg(20)->Arg(256)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// clock bookkeeping alone, at a 60 Hz frame rate on a 100 ms tick: what a frame costs when no tick is due
+static void BM_LoopThrottledOverhead(benchmark::State& state) {
+	FixedStep clock;
+	FixedStep::Clock::time_point now{};
+	clock.reset(now);
+	const std::chrono::milliseconds step(100);
+	uint64_t ticks = 0;
+	for (auto _ : state) {
+		now += std::chrono::microseconds(16667);
+		clock.beginFrame(now);
+		while (clock.tick(step)) ticks++;
+		benchmark::DoNotOptimize(clock.alpha(step));
+	}
+	state.counters["ticks/frame"] = static_cast<double>(ticks) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_LoopThrottledOverhead);
+
+// key presses pushed from a second thread and popped here; commands/s is the ring's
+// cross-thread throughput, far beyond any keyboard, i.e. the tick never waits on input
+static void BM_InputQueueSpsc(benchmark::State& state) {
+	InputQueue queue;
+	std::atomic<bool> stop{ false };
+	std::thread producer([&] {
+		const Direction turns[4] = { Direction::E, Direction::S, Direction::W, Direction::N };
+		InputCommand c;
+		for (uint64_t i = 0; !stop.load(std::memory_order_relaxed); i++) {
+			c.direction = turns[i & 3];
+			while (!queue.push(c) && !stop.load(std::memory_order_relaxed)) { std::this_thread::yield(); }
+		}
+	});
+
+	InputCommand c;
+	for (auto _ : state) {
+		while (!queue.pop(c)) { std::this_thread::yield(); }
+		benchmark::DoNotOptimize(c);
+	}
+	stop = true;
+	producer.join();
+	state.counters["commands/s"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_InputQueueSpsc)->UseRealTime();
@@ -0,0 +1,109 @@
+#include "Autopilot.h"
+#include "CompactSim.h"
+#include "MctsPlanner.h"
+#include "ParallelRunner.h"
+#include <benchmark/benchmark.h>
+
+// a 20x20 game some way in, so the body ring and grid are not trivially empty
+static GameSim midGame() {
+	GameSim sim(20, 20, 3);
+	Autopilot pilot;
+	while (!sim.isOver() && sim.score() < 40) sim.step(pilot.decide(sim));
+	return sim;
+}
+
+// what forking the game state costs: GameSim copies its heap vectors, CompactSim is one block
+static void BM_GameSimCopy(benchmark::State& state) {
+	const GameSim sim = midGame();
+	for (auto _ : state) {
+		GameSim copy(sim);
+		benchmark::DoNotOptimize(copy);
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_GameSimCopy);
+
+static void BM_CompactClone(benchmark::State& state) {
+	CompactSim root;
+	root.assign(midGame());
+	CompactSim slot;
+	for (auto _ : state) {
+		root.clone(slot);
+		benchmark::DoNotOptimize(slot);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+	state.counters["bytes"] = static_cast<double>(sizeof(CompactSim));
+}
+BENCHMARK(BM_CompactClone);
+
+// clone + reseed + a rollout of random safe moves, the inner loop of the planner, one core
+static void BM_CloneRollout(benchmark::State& state) {
+	const uint32_t rolloutTicks = static_cast<uint32_t>(state.range(0));
+	CompactSim root;
+	root.assign(midGame());
+	CompactSim slot;
+	Rng rng(7);
+	uint64_t ticks = 0;
+	for (auto _ : state) {
+		root.clone(slot);
+		slot.reseed(rng.next());
+		for (uint32_t t = 0; t < rolloutTicks && !slot.isOver(); t++) {
+			Cell h = slot.getHead();
+			int k = static_cast<int>(rng.below(4));
+			for (int i = 0; i < 4; i++, k = (k + 1) & 3) {
+				Cell v = directionAsVector(static_cast<Direction>(k));
+				if (!slot.isOppositeDirection(static_cast<Direction>(k)) && slot.isFree(h.x + v.x, h.y + v.y)) break;
+			}
+			slot.step(static_cast<Action>(k));
+			ticks++;
+		}
+		benchmark::DoNotOptimize(slot);
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+	state.counters["ticks/s"] = benchmark::Counter(static_cast<double>(ticks), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_CloneRollout)->ArgName("ticks")->Arg(32)->Arg(128);
+
+// one decision: 16 trees x 256 iterations dealt over the threads; items are rollouts, the
+// rate over wall time is what scales with the thread count
+static void BM_MctsDecide(benchmark::State& state) {
+	const unsigned nThreads = static_cast<unsigned>(state.range(0));
+	ParallelRunner runner(nThreads);
+	MctsConfig config;
+	config.nTrees = 16;
+	config.iterations = 256;
+	MctsPlanner planner(config, &runner);
+	CompactSim root;
+	root.assign(midGame());
+
+	for (auto _ : state) {
+		Action a = planner.decide(root);
+		benchmark::DoNotOptimize(a);
+	}
+	const MctsPlanner::Stats& st = planner.stats();
+	state.SetItemsProcessed(static_cast<int64_t>(st.rollouts));
+	state.counters["rollouts/s"] = benchmark::Counter(static_cast<double>(st.rollouts), benchmark::Counter::kIsRate);
+	state.counters["ticks/s"] = benchmark::Counter(static_cast<double>(st.ticks), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_MctsDecide)->ArgName("threads")->RangeMultiplier(2)->Range(1, 8)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// whole 20x20 games played by the planner (4 trees x 128 iterations a move, one thread)
+static void BM_MctsGame(benchmark::State& state) {
+	MctsConfig config;
+	config.nTrees = 4;
+	config.iterations = 128;
+	MctsPlanner planner(config);
+	GameSim sim(20, 20, 1);
+	uint64_t games = 0;
+	uint64_t scoreSum = 0;
+	for (auto _ : state) {
+		sim.reset(sim.seed() + 1);
+		while (!sim.isOver() && sim.ticks() < 2000) sim.step(planner.decide(sim));
+		games++;
+		scoreSum += static_cast<uint64_t>(sim.score());
+	}
+	state.counters["avg_score"] = static_cast<double>(scoreSum) / static_cast<double>(games);
+	state.counters["decisions/s"] = benchmark::Counter(static_cast<double>(planner.stats().decisions), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_MctsGame)->Iterations(3)->Unit(benchmark::kMillisecond);
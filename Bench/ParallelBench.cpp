@@ -0,0 +1,18 @@
+#include "BenchUtil.h"
+#include "ParallelRunner.h"
+#include <benchmark/benchmark.h>
+
+static void BM_ParallelEpisodes(benchmark::State& state) {
+	unsigned nThreads = static_cast<unsigned>(state.range(0));
+	const size_t nGames = 4096;
+	ParallelRunner runner(nThreads);
+
+	uint64_t ticks = 0;
+	for (auto _ : state) {
+		auto results = runner.runEpisodes(nGames, 20, 20, 42, [] { return Policy(greedyPolicy); });
+		for (const auto& r : results) ticks += r.ticks;
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(nGames));
+	state.counters["ticks/s"] = benchmark::Counter(static_cast<double>(ticks), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ParallelEpisodes)->RangeMultiplier(2)->Range(1, 64)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,161 @@
+#include "BenchUtil.h"
+#include "DisplayList.h"
+#include "Scene.h"
+#include "SoftwareRenderer.h"
+#include "SpanFill.h"
+#include <benchmark/benchmark.h>
+
+// one full game frame into an offscreen framebuffer, snake of about half the board
+static void BM_RenderFrame(benchmark::State& state) {
+	const int side = static_cast<int>(state.range(0));
+	const PixelFormat format = static_cast<PixelFormat>(state.range(1));
+	const int cellSize = 20;
+
+	GameSim sim(side, side, 7);
+	SerpentinePath path(side, side);
+	path.layout(sim, static_cast<size_t>(side) * static_cast<size_t>(side) / 2);
+
+	SceneLayout layout;
+	layout.init(cellSize, side);
+	std::vector<uint8_t> pixels(Framebuffer::bytesFor(layout.clientRect.width(), layout.clientRect.height(), format));
+	Framebuffer fb = Framebuffer::wrap(pixels.data(), layout.clientRect.width(), layout.clientRect.height(), format);
+	SoftwareRenderer r(fb);
+	SceneStyle style;
+	SceneState st;
+
+	for (auto _ : state) {
+		r.clear(style.background);
+		Scene::drawGamePlay(r, layout, style, sim, st);
+		benchmark::DoNotOptimize(pixels.data());
+		benchmark::ClobberMemory();
+	}
+	state.counters["fps"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+	state.counters["segments"] = static_cast<double>(sim.getSnake().nSegments());
+}
+BENCHMARK(BM_RenderFrame)
+	->ArgsProduct({ { 20, 40, 256 }, { static_cast<int64_t>(PixelFormat::RGBA8), static_cast<int64_t>(PixelFormat::Gray8) } })
+	->ArgNames({ "side", "format" });
+
+// one tick per frame, redrawing only the dirty cells and (every 10 ticks) the UI bar
+static void BM_RenderFrameDirty(benchmark::State& state) {
+	const int side = static_cast<int>(state.range(0));
+	const PixelFormat format = static_cast<PixelFormat>(state.range(1));
+	const int cellSize = 20;
+	const size_t length = static_cast<size_t>(side) * static_cast<size_t>(side) / 2;
+
+	GameSim sim(side, side, 7);
+	SerpentinePath path(side, side);
+	size_t head = path.layout(sim, length);
+
+	SceneLayout layout;
+	layout.init(cellSize, side);
+	std::vector<uint8_t> pixels(Framebuffer::bytesFor(layout.clientRect.width(), layout.clientRect.height(), format));
+	Framebuffer fb = Framebuffer::wrap(pixels.data(), layout.clientRect.width(), layout.clientRect.height(), format);
+	SoftwareRenderer r(fb);
+	SceneStyle style;
+	SceneState st;
+	SceneCache shown;
+	Scene::drawDirty(r, layout, style, sim, st, shown);
+	sim.clearDirty();
+
+	for (auto _ : state) {
+		if (head + 1 >= path.cells.size()) { // end of the path, start over with a full frame
+			state.PauseTiming();
+			head = path.layout(sim, length);
+			Scene::drawDirty(r, layout, style, sim, st, shown);
+			sim.clearDirty();
+			state.ResumeTiming();
+		}
+		sim.step(path.actionAt(head++));
+		st.elapsedSec = static_cast<int>(sim.ticks() / 10);
+		Scene::drawDirty(r, layout, style, sim, st, shown);
+		sim.clearDirty();
+		benchmark::ClobberMemory();
+	}
+	state.counters["fps"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_RenderFrameDirty)
+	->ArgsProduct({ { 20, 40, 256 }, { static_cast<int64_t>(PixelFormat::RGBA8), static_cast<int64_t>(PixelFormat::Gray8) } })
+	->ArgNames({ "side", "format" });
+
+// board only (snake + bait), one square per object vs one cell pass; pixels = board area
+struct BoardFixture {
+	GameSim sim;
+	SceneLayout layout;
+	std::vector<uint8_t> pixels;
+	Framebuffer fb;
+
+	BoardFixture(int side, int cellSize, PixelFormat format) : sim(side, side, 7) {
+		SerpentinePath path(side, side);
+		path.layout(sim, static_cast<size_t>(side) * static_cast<size_t>(side) / 2);
+		layout.init(cellSize, side);
+		pixels.resize(Framebuffer::bytesFor(layout.clientRect.width(), layout.clientRect.height(), format));
+		fb = Framebuffer::wrap(pixels.data(), layout.clientRect.width(), layout.clientRect.height(), format);
+	}
+
+	int64_t boardPixels() const { return static_cast<int64_t>(layout.gameRect.width()) * layout.gameRect.height(); }
+};
+
+static void BM_RenderBoardPerObject(benchmark::State& state) {
+	BoardFixture f(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)), static_cast<PixelFormat>(state.range(2)));
+	SoftwareRenderer r(f.fb);
+	SceneStyle style;
+	for (auto _ : state) {
+		Scene::drawSnake(r, f.layout, style, f.sim.getSnake());
+		Scene::drawBait(r, f.layout, style, f.sim.getBait());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * f.boardPixels());
+}
+
+static void BM_RenderBoardCells(benchmark::State& state) {
+	BoardFixture f(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)), static_cast<PixelFormat>(state.range(2)));
+	SoftwareRenderer r(f.fb);
+	SceneStyle style;
+	CellLayer cells;
+	for (auto _ : state) {
+		cells.build(f.sim);
+		Scene::drawBoard(r, f.layout, style, cells);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * f.boardPixels());
+	state.SetLabel(SpanFill::path());
+}
+
+#define BOARD_ARGS \
+	ArgsProduct({ { 20, 64, 256 }, { 4, 20 }, { static_cast<int64_t>(PixelFormat::RGBA8), static_cast<int64_t>(PixelFormat::Gray8) } }) \
+	->ArgNames({ "side", "cell", "format" })
+BENCHMARK(BM_RenderBoardPerObject)->BOARD_ARGS;
+BENCHMARK(BM_RenderBoardCells)->BOARD_ARGS;
+
+// game play frame recorded into a display list and replayed; "batches" (backend state
+// changes) should not move with the snake length, only rects and commands do (checked
+// in Tests/DisplayListTest)
+static void BM_DisplayListFrame(benchmark::State& state) {
+	const int side = 64;
+	const size_t length = static_cast<size_t>(state.range(0));
+
+	GameSim sim(side, side, 7);
+	SerpentinePath path(side, side);
+	path.layout(sim, length);
+
+	SceneLayout layout;
+	layout.init(8, side);
+	std::vector<uint8_t> pixels(Framebuffer::bytesFor(layout.clientRect.width(), layout.clientRect.height(), PixelFormat::RGBA8));
+	SoftwareRenderer r(Framebuffer::wrap(pixels.data(), layout.clientRect.width(), layout.clientRect.height(), PixelFormat::RGBA8));
+	SceneStyle style;
+	SceneState st;
+	DisplayList list;
+
+	for (auto _ : state) {
+		list.reset();
+		list.clear(style.background);
+		Scene::drawGamePlay(list, layout, style, sim, st);
+		list.replay(r);
+		benchmark::ClobberMemory();
+	}
+	state.counters["batches"] = static_cast<double>(list.stats().batches);
+	state.counters["rects"] = static_cast<double>(list.stats().rects);
+	state.counters["commands"] = static_cast<double>(list.stats().commands);
+}
+BENCHMARK(BM_DisplayListFrame)->ArgName("length")->Arg(3)->Arg(64)->Arg(512)->Arg(2048)->Arg(4000);
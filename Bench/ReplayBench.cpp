@@ -0,0 +1,68 @@
+#include "BenchUtil.h"
+#include "Replay.h"
+#include <benchmark/benchmark.h>
+
+// a greedy game of a few hundred ticks, with bait-chasing turns every few ticks
+static Replay recordGreedyGame(uint64_t seed) {
+	GameSim sim(20, 20, seed);
+	ReplayRecorder rec;
+	rec.begin(sim);
+	while (!sim.isOver()) {
+		sim.step(greedyPolicy(sim));
+		rec.onStep(sim);
+	}
+	return rec.finish(sim);
+}
+
+static void BM_ReplayEncode(benchmark::State& state) {
+	Replay replay = recordGreedyGame(3);
+	size_t bytes = 0;
+	for (auto _ : state) {
+		auto v = replay.encode();
+		bytes = v.size();
+		benchmark::DoNotOptimize(v.data());
+	}
+	state.counters["bytes"] = static_cast<double>(bytes);
+	state.counters["bytes/game-min"] = static_cast<double>(bytes) * 600.0 / static_cast<double>(replay.ticks); // 100 ms ticks
+}
+BENCHMARK(BM_ReplayEncode);
+
+// full playback; one game minute is 600 ticks, so real time factor = ticks/s / 10
+static void BM_ReplayPlayback(benchmark::State& state) {
+	Replay replay = recordGreedyGame(3);
+	for (auto _ : state) {
+		ReplayPlayer player(replay);
+		while (player.stepForward()) { }
+		benchmark::DoNotOptimize(player.sim().score());
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(replay.ticks));
+}
+BENCHMARK(BM_ReplayPlayback);
+
+// random seeks in a long game once the keyframes exist
+static void BM_ReplaySeek(benchmark::State& state) {
+	const uint64_t interval = static_cast<uint64_t>(state.range(0));
+
+	// the snake circles a 4x4 loop; on a 64x64 board the bait is (almost surely) never on it
+	Replay replay;
+	replay.width = 64;
+	replay.height = 64;
+	replay.seed = 1;
+	replay.ticks = 100000;
+	for (uint64_t t = 4; t < replay.ticks; t += 4) {
+		replay.turns.push_back(TurnEvent{ t, static_cast<Direction>((t / 4) % 4) });
+	}
+
+	ReplayPlayer player(replay, interval);
+	player.seek(replay.ticks);
+	if (player.tick() != replay.ticks) {
+		state.SkipWithError("the looping snake died, pick another seed");
+		return;
+	}
+	Rng rng(1);
+	for (auto _ : state) {
+		player.seek(rng.below(static_cast<uint32_t>(replay.ticks + 1)));
+		benchmark::DoNotOptimize(player.tick());
+	}
+}
+BENCHMARK(BM_ReplaySeek)->Arg(256)->Arg(4096);
@@ -0,0 +1,26 @@
+# Runs SnakeBench and writes its results as JSON, named after the commit they measure,
+# so runs from different commits can be compared (e.g. with Google Benchmark's compare.py).
+#
+#	cmake -DBENCH=<SnakeBench> -DSOURCE_DIR=<repo> -DOUT_DIR=<dir> [-DFILTER=<regex>] -P RunBench.cmake
+#
+# The bench_json target runs it with the build's own paths.
+
+if(NOT FILTER)
+	set(FILTER ".")
+endif()
+
+execute_process(COMMAND git rev-parse --short HEAD
+	WORKING_DIRECTORY ${SOURCE_DIR}
+	OUTPUT_VARIABLE rev OUTPUT_STRIP_TRAILING_WHITESPACE
+	RESULT_VARIABLE rc ERROR_QUIET)
+if(NOT rc EQUAL 0 OR NOT rev)
+	set(rev "unknown")
+endif()
+
+set(out ${OUT_DIR}/bench-${rev}.json)
+execute_process(COMMAND ${BENCH} --benchmark_filter=${FILTER} --benchmark_out=${out} --benchmark_out_format=json
+	RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+	message(FATAL_ERROR "SnakeBench failed (${rc})")
+endif()
+message(STATUS "Wrote ${out}")
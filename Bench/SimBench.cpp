@@ -0,0 +1,119 @@
+#include "BenchUtil.h"
+#include "Scene.h"
+#include "SoftwareRenderer.h"
+#include <benchmark/benchmark.h>
+
+// The hot paths one by one, by board side and snake length; the snake follows a CycleTour
+// so it never dies and is laid out once per run.
+//
+//	SnakeBench --benchmark_filter=BM_Sim --benchmark_out=sim.json --benchmark_out_format=json
+//
+// or the bench_json target, which names the file after the current commit.
+
+// a Snake of `length` on a bare Board, unfolded along the tour; returns the head's tour index
+static size_t unfold(Snake& snake, Board& board, const CycleTour& tour, size_t length) {
+	board.reset(tour.side, tour.side);
+	snake.reset(tour.cellAt(0), board);
+	if (length > snake.getSize()) snake.grow(length - snake.getSize());
+	size_t head = 0;
+	while (head + 1 < length) {
+		snake.setDirection(static_cast<Direction>(tour.actionAt(head++)));
+		snake.move(board);
+	}
+	return head;
+}
+
+// Snake::move: tail off the board, head on, collision bit
+static void BM_SimSnakeMove(benchmark::State& state) {
+	CycleTour tour(static_cast<int>(state.range(0)));
+	const std::vector<Action> lap = tour.actions();
+	Board board;
+	Snake snake;
+	size_t head = unfold(snake, board, tour, static_cast<size_t>(state.range(1)));
+
+	for (auto _ : state) {
+		snake.setDirection(static_cast<Direction>(lap[head]));
+		bool hit = snake.move(board);
+		benchmark::DoNotOptimize(hit);
+		if (++head == lap.size()) head = 0;
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_SimSnakeMove)->Apply(boardAndLengthArgs);
+
+// Snake::grow followed by the move that unfolds the new segment (no tail to clear);
+// the snake starts over at `length` once it covers three quarters of the board
+static void BM_SimSnakeGrow(benchmark::State& state) {
+	CycleTour tour(static_cast<int>(state.range(0)));
+	const std::vector<Action> lap = tour.actions();
+	const size_t length = static_cast<size_t>(state.range(1));
+	const size_t maxLength = tour.size() / 4 * 3;
+	Board board;
+	Snake snake;
+	size_t head = unfold(snake, board, tour, length);
+
+	for (auto _ : state) {
+		if (snake.getSize() >= maxLength) {
+			state.PauseTiming();
+			head = unfold(snake, board, tour, length);
+			state.ResumeTiming();
+		}
+		snake.grow(1);
+		snake.setDirection(static_cast<Direction>(lap[head]));
+		bool hit = snake.move(board);
+		benchmark::DoNotOptimize(hit);
+		if (++head == lap.size()) head = 0;
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_SimSnakeGrow)->Apply(boardAndLengthArgs);
+
+// GameSim::placeBait: one uniform pick among the free cells, whatever the board fill
+static void BM_SimPlaceBait(benchmark::State& state) {
+	CycleTour tour(static_cast<int>(state.range(0)));
+	GameSim sim(tour.side, tour.side, 1);
+	tour.layout(sim, static_cast<size_t>(state.range(1)));
+
+	for (auto _ : state) {
+		bool placed = sim.placeBait();
+		benchmark::DoNotOptimize(placed);
+		sim.clearDirty();
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_SimPlaceBait)->Apply(boardAndLengthArgs);
+
+// full game play frame into an offscreen framebuffer; cells are scaled so the frame stays
+// within about 1024 px (4096 x 4096 boards: 1 px per cell). cells:0 draws one square per
+// segment, cells:1 goes through CellLayer and one drawCells pass
+static void BM_SimRenderFrame(benchmark::State& state) {
+	CycleTour tour(static_cast<int>(state.range(0)));
+	const bool viaCells = state.range(2) != 0;
+	GameSim sim(tour.side, tour.side, 1);
+	tour.layout(sim, static_cast<size_t>(state.range(1)));
+
+	int cellSize = 1024 / tour.side;
+	SceneLayout layout;
+	layout.init(cellSize < 1 ? 1 : cellSize, tour.side);
+	std::vector<uint8_t> pixels(Framebuffer::bytesFor(layout.clientRect.width(), layout.clientRect.height(), PixelFormat::RGBA8));
+	SoftwareRenderer r(Framebuffer::wrap(pixels.data(), layout.clientRect.width(), layout.clientRect.height(), PixelFormat::RGBA8));
+	SceneStyle style;
+	SceneState st;
+	CellLayer cells;
+
+	for (auto _ : state) {
+		r.clear(style.background);
+		if (viaCells) Scene::drawGamePlay(r, layout, style, sim, st, cells);
+		else Scene::drawGamePlay(r, layout, style, sim, st);
+		benchmark::ClobberMemory();
+	}
+	state.counters["fps"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+static void renderArgs(benchmark::internal::Benchmark* b) {
+	b->ArgNames({ "side", "length", "cells" });
+	for (const std::vector<int64_t>& a : boardAndLengths()) {
+		b->Args({ a[0], a[1], 0 });
+		b->Args({ a[0], a[1], 1 });
+	}
+}
+BENCHMARK(BM_SimRenderFrame)->Apply(renderArgs)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,61 @@
+#include "SpriteAtlas.h"
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+// Landing animation startup, before (13 separate 24-bit BMPs) and after (one packed atlas).
+// The Win32 build loads them from resources, this reads the same bytes from the source tree.
+
+static std::string titleFile(const std::string& name) { return std::string(SNAKE_TITLE_DIR) + "/" + name; }
+
+static std::vector<uint8_t> readFile(const std::string& path) {
+	std::ifstream f(path, std::ios::binary);
+	return std::vector<uint8_t>((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+}
+
+static void BM_TitleLoadBmps(benchmark::State& state) {
+	size_t bytes = 0;
+	for (auto _ : state) {
+		bytes = 0;
+		for (int i = 1; i <= 13; i++) {
+			SpriteImage img;
+			if (!SpriteImage::loadBmp(titleFile("s" + std::to_string(i) + ".bmp"), img)) {
+				state.SkipWithError("missing TitleSnake BMPs");
+				return;
+			}
+			bytes += img.bgr.size();
+			benchmark::DoNotOptimize(img.bgr.data());
+		}
+	}
+	state.counters["residentBytes"] = static_cast<double>(bytes);
+}
+BENCHMARK(BM_TitleLoadBmps)->Unit(benchmark::kMicrosecond);
+
+// frames:1 is what startup does now (frame 0 only), frames:13 a whole animation cycle
+static void BM_TitleLoadAtlas(benchmark::State& state) {
+	const int frames = static_cast<int>(state.range(0));
+	size_t encoded = 0;
+	size_t surfaceBytes = 0;
+	for (auto _ : state) {
+		std::vector<uint8_t> data = readFile(titleFile("title.snkatlas"));
+		SpriteAtlas atlas;
+		if (!atlas.open(data.data(), data.size())) {
+			state.SkipWithError("missing or corrupt title.snkatlas");
+			return;
+		}
+		size_t stride = SpriteAtlas::surfaceStride(atlas.frameWidth());
+		std::vector<uint8_t> surface(stride * static_cast<size_t>(atlas.frameHeight()) * static_cast<size_t>(atlas.frameCount()));
+		atlas.setSurface(surface.data(), stride);
+		if (!atlas.decodeUpTo(frames - 1)) {
+			state.SkipWithError("atlas does not decode");
+			return;
+		}
+		encoded = data.size();
+		surfaceBytes = surface.size();
+		benchmark::DoNotOptimize(surface.data());
+	}
+	state.counters["encodedBytes"] = static_cast<double>(encoded);
+	state.counters["residentBytes"] = static_cast<double>(encoded + surfaceBytes);
+}
+BENCHMARK(BM_TitleLoadAtlas)->ArgName("frames")->Arg(1)->Arg(13)->Unit(benchmark::kMicrosecond);
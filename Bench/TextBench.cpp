@@ -0,0 +1,34 @@
+#include "AllocCount.h"
+#include "GameSim.h"
+#include "Scene.h"
+#include "SoftwareRenderer.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+// UI bar plus the pause and game over overlays, i.e. all the text a frame can show;
+// prepared:1 draws the overlays from the static string atlas
+static void BM_RenderText(benchmark::State& state) {
+	const bool prepared = state.range(0) != 0;
+	SceneLayout layout;
+	layout.init(20, 20);
+	std::vector<uint8_t> pixels(Framebuffer::bytesFor(layout.clientRect.width(), layout.clientRect.height(), PixelFormat::RGBA8));
+	SoftwareRenderer r(Framebuffer::wrap(pixels.data(), layout.clientRect.width(), layout.clientRect.height(), PixelFormat::RGBA8));
+	SceneStyle style;
+	if (prepared) Scene::prepareText(r, style);
+	GameSim sim(20, 20, 7);
+	SceneState st;
+	Scene::drawGameOver(r, layout, style, sim, st); // warm up: glyph sets of the used scales
+
+	size_t allocs = allocationCount();
+	int frame = 0;
+	for (auto _ : state) {
+		Scene::drawGamePlayUi(r, layout, style, frame, frame / 10);
+		Scene::drawPause(r, layout, style);
+		Scene::drawGameOver(r, layout, style, sim, st);
+		frame++;
+		benchmark::ClobberMemory();
+	}
+	allocs = allocationCount() - allocs;
+	state.counters["allocs/frame"] = static_cast<double>(allocs) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_RenderText)->ArgName("prepared")->Arg(0)->Arg(1);
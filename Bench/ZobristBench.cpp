@@ -0,0 +1,44 @@
+#include "GameSim.h"
+#include "Rng.h"
+#include "TranspositionTable.h"
+#include <benchmark/benchmark.h>
+
+// steps of random games with the hash read every tick: the XORs ride along in Snake::move,
+// so this should stay at the cost of a plain step
+static void BM_HashedStep(benchmark::State& state) {
+	const int side = static_cast<int>(state.range(0));
+	GameSim sim(side, side, 1);
+	Rng rng(2);
+	uint64_t acc = 0;
+	for (auto _ : state) {
+		if (sim.isOver()) sim.reset(rng.next());
+		sim.step(static_cast<Action>(rng.below(4)));
+		acc ^= sim.hash();
+	}
+	benchmark::DoNotOptimize(acc);
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_HashedStep)->Arg(20)->Arg(256);
+
+// probe then store of random states into one table shared by all threads, 4M entries (64 MB)
+static TranspositionTable& sharedTable() {
+	static TranspositionTable table(size_t(1) << 22);
+	return table;
+}
+
+static void BM_TTProbeStore(benchmark::State& state) {
+	TranspositionTable& table = sharedTable();
+	uint64_t s = static_cast<uint64_t>(state.thread_index()) + 1;
+	int64_t hits = 0;
+	for (auto _ : state) {
+		const uint64_t key = Rng::splitmix64(s) & 0x3FFFFF; // revisits, like a search does
+		const uint64_t hash = key * 0x9E3779B97F4A7C15ull;
+		TTEntry e;
+		if (table.probe(hash, e)) hits++;
+		e.depth = static_cast<uint16_t>(key);
+		table.store(hash, e);
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+	state.counters["hit%"] = benchmark::Counter(100.0 * static_cast<double>(hits) / static_cast<double>(state.iterations()), benchmark::Counter::kAvgThreads);
+}
+BENCHMARK(BM_TTProbeStore)->ThreadRange(1, 4)->UseRealTime();
@@ -12,19 +12,7 @@
 #define IDI_SMALL                       108
 #define IDC_SNAKE                       109
 #define IDR_MAINFRAME                   128
-#define IDB_BITMAP1                     129
-#define IDB_BITMAP2                     130
-#define IDB_BITMAP3                     131
-#define IDB_BITMAP4                     132
-#define IDB_BITMAP5                     133
-#define IDB_BITMAP6                     134
-#define IDB_BITMAP7                     135
-#define IDB_BITMAP8                     136
-#define IDB_BITMAP9                     137
-#define IDB_BITMAP10                    138
-#define IDB_BITMAP11                    139
-#define IDB_BITMAP12                    140
-#define IDB_BITMAP13                    141
+#define IDR_TITLE_ATLAS                 129
 #define IDC_STATIC                      -1
 
 // Next default values for new objects
@@ -32,7 +20,7 @@
 #ifdef APSTUDIO_INVOKED
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NO_MFC                     1
-#define _APS_NEXT_RESOURCE_VALUE        142
+#define _APS_NEXT_RESOURCE_VALUE        130
 #define _APS_NEXT_COMMAND_VALUE         32771
 #define _APS_NEXT_CONTROL_VALUE         1000
 #define _APS_NEXT_SYMED_VALUE           110
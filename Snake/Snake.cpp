@@ -3,6 +3,9 @@
 
 #include "framework.h"
 #include "Snake.h"
+#include <timeapi.h>
+
+#pragma comment(lib, "winmm.lib")
 
 #define MAX_LOADSTRING 100
 
@@ -43,17 +46,30 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 
     HACCEL hAccelTable = LoadAccelerators(hInstance, MAKEINTRESOURCE(IDC_SNAKE));
 
-    MSG msg;
+    MSG msg{};
 
-    // Main message loop:
-    while (GetMessage(&msg, nullptr, 0, 0))
+    // Main loop: pending messages first, then whatever game ticks are due (Game::frame),
+    // then sleep until the next tick or until input arrives, whichever comes first.
+    timeBeginPeriod(1); // 1 ms wait granularity instead of the 15.6 ms default
+    for (;;)
     {
-        if (!TranslateAccelerator(msg.hwnd, hAccelTable, &msg))
+        if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
         {
-            TranslateMessage(&msg);
+            if (msg.message == WM_QUIT) break;
+            if (!TranslateAccelerator(msg.hwnd, hAccelTable, &msg))
+            {
+                TranslateMessage(&msg);
                 DispatchMessage(&msg);
+            }
+            continue;
+        }
+        DWORD waitMs = g.frame();
+        if (waitMs > 0)
+        {
+            MsgWaitForMultipleObjectsEx(0, nullptr, waitMs, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
         }
     }
+    timeEndPeriod(1);
 
     return (int) msg.wParam;
 }
@@ -134,7 +150,6 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 
         g.init(hWnd);
         g.restart();
-        SetTimer(hWnd, 0, static_cast<UINT>(g.getSnake().getSpeed()), nullptr);
     }
 
     case WM_COMMAND:
@@ -154,20 +169,21 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             }
         }
         break;
-    case WM_TIMER: {
-        g.update();
-    } break;
-
     case WM_KEYDOWN: {
         
-        Snake& s = g.getSnake();
         switch (wParam) {
-            case VK_UP:     { s.onKeyUp();    }  break;
-            case VK_DOWN:   { s.onKeyDown();  }  break;
-            case VK_LEFT:   { s.onKeyLeft();  }  break;
-            case VK_RIGHT:  { s.onKeyRight(); }  break;
+            case VK_UP:     { g.onDirection(Direction::N); }  break;
+            case VK_DOWN:   { g.onDirection(Direction::S); }  break;
+            case VK_LEFT:   { g.onDirection(Direction::W); }  break;
+            case VK_RIGHT:  { g.onDirection(Direction::E); }  break;
             case VK_SPACE:  { g.onSpace();    }  break;
             case VK_ESCAPE: { g.onEsc();      }  break;
+            case 'I':       { g.toggleInterpolation(); } break;
+            case 'U':       { g.toggleUnthrottled();   } break; // benchmarking
+            case 'L':       { g.toggleLatency();       } break;
+            case 'K':       { g.dumpLatency();         } break;
+            case 'A':       { g.toggleAutopilot();     } break;
+            case 'R':       { g.toggleReplayArchive(); } break; // opt-in, %LOCALAPPDATA%\Snake
             
             //case VK_RETURN: { g.update(); } break; //debug
             //case VK_ESCAPE: { g.restart(); } break; //debug
@@ -176,10 +192,12 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
     } break;
     case WM_PAINT:
         {
+            g.captureUpdateRegion(); // BeginPaint empties the update region
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hWnd, &ps);
-            g.draw(hdc);
+            g.draw(hdc, ps.rcPaint);
             EndPaint(hWnd, &ps);
+            g.onPresented();
         }
         break;
     case WM_DESTROY:
@@ -2,124 +2,120 @@
 
 #include "resource.h"
 #include "Resource.h"
+#include "SnakeSim.h"
 #include <vector>
 #include <cassert>
 #include <stdexcept>
 #include <string>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
 #include <time.h>
 
-
-enum class Direction { N = 0,  E,  S, W	 };
-
-class MyBitMap {
-	int _id = 0;
-	HBITMAP _bitmap = NULL;
-	BITMAP _info;
-
-public:
-	MyBitMap() = delete;
-	MyBitMap(int id_) : _id(id_) { init(_id); };
-
-	void init(int id) {
-		loadFromResource(id);
-		int result = GetObject(_bitmap, sizeof(_info), &_info);
-		if (result <= 0) {
-			auto e = GetLastError();
-			return;
-		}
-	}
-
-	void loadFromResource(int id) {
-		_bitmap = LoadBitmap(GetModuleHandle(nullptr), MAKEINTRESOURCE(id));
-	}
-
-	const BITMAP&	info()    const { return _info;          }
-	const HBITMAP&	bitmap()  const { return _bitmap;		 }
-	const LONG&	    width()	  const { return _info.bmWidth;  }
-	const LONG&	    height()  const { return _info.bmHeight; }
-
-	int id() const { return _id; }
-
-	void draw(HDC hdc_, HDC srcDC, int x_, int y_) const {
-		if (!_bitmap) { assert(false); return; }
-		if (!srcDC) { assert(false); return; }
-	
-		SelectObject(srcDC, _bitmap);
-		
-		int is_ok = BitBlt(hdc_, x_, y_, (int)width(), (int)height(), srcDC, 0, 0, SRCCOPY);
-		if (!is_ok) { 
-			int e = GetLastError(); 
-			return;
-		}
-	}
-};
-
+// Landing animation from the packed RCDATA atlas (see SpriteAtlas.h, Tools/PackSprites).
+// Frames are decoded lazily into one 8-bit DIB section holding all of them, which is
+// selected into the source DC once; drawing a frame is a BitBlt of its sub-rect.
 class Sprite {
+	int _resourceId = 0;
 	int _currentFrameIdx = 0;
-	int _beginFrameId = 0;
-	int _endFrameId = 0;
-	std::vector<MyBitMap> _frames;
+	SpriteAtlas _atlas;
+	HBITMAP _surface = NULL;
+	mutable HDC _selectedInto = NULL;
 
 public:
 	Sprite() = default;
-	Sprite(int beginFrameId_, int endFrameId_) : _beginFrameId(beginFrameId_), _endFrameId(endFrameId_) { init(); };
+	explicit Sprite(int resourceId_) : _resourceId(resourceId_) { init(); }
+	~Sprite() { if (_surface) { DeleteObject(_surface); } }
+	Sprite(const Sprite&) = delete;
+	Sprite& operator=(const Sprite&) = delete;
 
 	void init() {
-		for (int id = _beginFrameId; id < _endFrameId + 1; id++) {
-			_frames.emplace_back(id);
-		}
-	}
-
-	int nFrames() const { return (int)_frames.size(); }
-
-	const MyBitMap& currentFrame() const {
-		if (_frames.size() == 0) assert(false);
-		return _frames[_currentFrameIdx];
-	}
-
-	const LONG& width() const {
-		return currentFrame().width();
-	}
-
-	const LONG& height() const {
-		return currentFrame().height();
-	}
-
-	const int currentFrameIdx() const { return _currentFrameIdx; }
+		HMODULE module = GetModuleHandle(nullptr);
+		HRSRC res = FindResource(module, MAKEINTRESOURCE(_resourceId), RT_RCDATA);
+		if (!res) { assert(false); return; }
+		// resource memory stays mapped for the life of the module, the atlas reads it in place
+		const uint8_t* data = static_cast<const uint8_t*>(LockResource(LoadResource(module, res)));
+		if (!_atlas.open(data, SizeofResource(module, res))) { assert(false); return; }
+
+		struct {
+			BITMAPINFOHEADER header;
+			RGBQUAD colors[256];
+		} bmi = {};
+		bmi.header.biSize = sizeof(BITMAPINFOHEADER);
+		bmi.header.biWidth = _atlas.frameWidth();
+		bmi.header.biHeight = -(_atlas.frameHeight() * _atlas.frameCount()); // top-down, frames stacked
+		bmi.header.biPlanes = 1;
+		bmi.header.biBitCount = 8;
+		bmi.header.biCompression = BI_RGB;
+		bmi.header.biClrUsed = static_cast<DWORD>(_atlas.paletteSize());
+		memcpy(bmi.colors, _atlas.palette(), 4 * static_cast<size_t>(_atlas.paletteSize()));
+
+		void* bits = nullptr;
+		_surface = CreateDIBSection(NULL, reinterpret_cast<BITMAPINFO*>(&bmi), DIB_RGB_COLORS, &bits, NULL, 0);
+		if (!_surface) { assert(false); return; }
+		_atlas.setSurface(static_cast<uint8_t*>(bits), SpriteAtlas::surfaceStride(_atlas.frameWidth()));
+		_atlas.decodeUpTo(0);
+	}
+
+	int nFrames() const { return _atlas.frameCount(); }
+	LONG width()  const { return _atlas.frameWidth(); }
+	LONG height() const { return _atlas.frameHeight(); }
+	int currentFrameIdx() const { return _currentFrameIdx; }
 
 	void draw(HDC hdc_, HDC srcDC_, int x_, int y_) const {
-		currentFrame().draw(hdc_, srcDC_, x_, y_);
+		if (!_surface) { assert(false); return; }
+		if (!srcDC_) { assert(false); return; }
+		if (_selectedInto != srcDC_) { // the DC only ever holds this surface
+			SelectObject(srcDC_, _surface);
+			_selectedInto = srcDC_;
+		}
+		BitBlt(hdc_, x_, y_, (int)width(), (int)height(), srcDC_, 0, _atlas.frameTop(_currentFrameIdx), SRCCOPY);
 	}
 
 	void nextFrame() {
+		if (nFrames() == 0) return;
 		_currentFrameIdx = (_currentFrameIdx + 1) % nFrames();
+		_atlas.decodeUpTo(_currentFrameIdx); // a no-op after the first cycle
 	}
 };
 
-class Util {
-public:
+// HFONTs by (face, size), created on first use and kept for the life of the process,
+// so drawing text never creates or leaks a font per frame.
+class FontCache {
+	struct Entry {
+		const wchar_t* face;
+		int size;
+		HFONT font;
+	};
 
-	static int getRandomInt(const int from, const int to) {
-		int dist = to - from + 1;
-		return from + (rand() % dist);
+	static std::vector<Entry>& entries() {
+		static std::vector<Entry> e;
+		return e;
 	}
-	
-	static POINT getRandomPointInRect(RECT& r) {
-		int randX = getRandomInt(r.left, r.right);
-		int randY = getRandomInt(r.top, r.bottom);
-		POINT p{ randX, randY };
-		return p;
+
+public:
+	static HFONT get(const wchar_t* face, int size) {
+		for (const Entry& e : entries()) {
+			if (e.size == size && wcscmp(e.face, face) == 0) return e.font;
+		}
+		HFONT hf = CreateFont(/*size=*/-size, 0, 0, 0, FW_NORMAL, 0, 0, 0, ANSI_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, DEFAULT_QUALITY, DEFAULT_PITCH, face);
+		entries().push_back(Entry{ face, size, hf });
+		return hf;
 	}
 };
 
 class Painter {
 
 public:
-	static void drawSquare(HDC hdc_, POINT pos_, size_t size_, COLORREF color)
-	{
-		SelectObject(hdc_, GetStockObject(DC_BRUSH));
-		SetDCBrushColor(hdc_, color);
-		Rectangle(hdc_, pos_.x, pos_.y, pos_.x + static_cast<int>(size_), pos_.y + static_cast<int>(size_));
+	// where drawTitle blits the animation, centred in the client area
+	static RECT titleSpriteRect(HWND hWnd_, const Sprite& sprite_) {
+		RECT cr;
+		GetClientRect(hWnd_, &cr);
+		LONG x = cr.left + (cr.right - cr.left) / 2 - sprite_.width() / 2;
+		LONG y = cr.top + (cr.bottom - cr.top) / 2 - sprite_.height() / 2;
+		RECT r{ x, y, x + sprite_.width(), y + sprite_.height() };
+		return r;
 	}
 
 	static void drawTitle(HWND hWnd_, HDC hdc_, HDC srcDC_, const Sprite& sprite_) {
@@ -128,15 +124,9 @@ public:
 		GetClientRect(hWnd_, &cr);
 		tmpCrRect = cr;
 		
-		
-		LONG cr_w = cr.right - cr.left;
 		LONG cr_h = cr.bottom - cr.top;
-		POINT spos;
-		POINT cr_mid;
-		cr_mid.x = cr.left + cr_w / 2;
-		cr_mid.y = cr.top + cr_h / 2;
-		spos.x = cr_mid.x - sprite_.width()  / 2;
-		spos.y = cr_mid.y - sprite_.height() / 2 ;
+		RECT sr = titleSpriteRect(hWnd_, sprite_);
+		POINT spos{ sr.left, sr.top };
 		
 		bool b = sprite_.currentFrameIdx() == sprite_.nFrames() - 1;
 		Rectangle(hdc_, spos.x - 5, spos.y - 5, spos.x + sprite_.width() + 5, spos.y + sprite_.height() + 5);	
@@ -176,10 +166,8 @@ public:
 		SetBkColor(hdc_, bgColor);
 		if (fontSize) {
 			int savedDC = SaveDC(hdc_);
-			HFONT hf = CreateFont(/*size=*/-fontSize, 0, 0, 0, FW_NORMAL, 0, 0, 0, ANSI_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, DEFAULT_QUALITY, DEFAULT_PITCH, L"MS Sans Serif");
-			SelectObject(hdc_, hf);
+			SelectObject(hdc_, FontCache::get(L"MS Sans Serif", fontSize));
 			DrawText(hdc_, s, (int)wcslen(s), &rect_, format);
-			DeleteObject(hf);
 			RestoreDC(hdc_, savedDC);
 		}
 		else {
@@ -191,219 +179,64 @@ public:
 };
 
 
-class GameObject {
+inline COLORREF toColorRef(Color c) { return RGB(c.r, c.g, c.b); }
+inline RECT toRect(const RectI& r) { RECT rc{ r.left, r.top, r.right, r.bottom }; return rc; }
+inline RectI toRectI(const RECT& r) { RectI ri{ r.left, r.top, r.right, r.bottom }; return ri; }
 
-protected:
-	POINT _pos{ 0, 0 };
-	size_t _size = 30;
+// Renderer backend for the shared Scene code, drawing to a GDI device context.
+class GdiRenderer : public Renderer {
+	HWND _hWnd;
+	HDC _hdc;
 
 public:
-	//GameObject() = delete;
-	GameObject(int x = 0, int y = 0, size_t size_ = 30)
-	{
-		_pos.x = x;
-		_pos.y = y;
-		_size = size_;
-	}
-	~GameObject() {
-		reset();
-	}
-	void resetPos() { setPos(0, 0); }
-	void resetSize() { setSize(0); }
-	
-	virtual void reset() { 
-		resetPos();
-		resetSize();
-	};
-	
-	const POINT& getPos() const { return _pos; }
-	POINT getPos() { return _pos; }
-	
-	POINT getNextPos(const int x, const int y) const {
-		POINT p = getPos();
-		p.x += x;
-		p.y += y;
-		return  p;
-	}
-	
-	void setPos(const int x_, const int y_) { _pos.x = x_; _pos.y = y_; }
-	void setPos(const POINT pos_) { setPos(pos_.x, pos_.y); }
-	
-	
-	size_t getSize() const 			{ return _size; };
-	void setSize(const size_t size) { _size = size; };
+	GdiRenderer(HWND hWnd_, HDC hdc_) : _hWnd(hWnd_), _hdc(hdc_) { }
 
-	RECT hitBox() const {
-		RECT r{ _pos.x, _pos.y, _pos.x + static_cast<LONG>(_size), _pos.y + static_cast<LONG>(_size)};
-		return r;
-	}
-
-	bool isCollided(const GameObject& other) const { 
-		RECT t;
-		RECT thisBox = hitBox();
-		RECT otherBox = other.hitBox();
-		return IntersectRect(&t, &thisBox, &otherBox) != 0;
-	}
-
-};
-
-
-
-class SnakeBody : GameObject {
-	friend class Snake;
-	friend class Game;
-
-public:	
-	SnakeBody(int x_, int y_, size_t size_ = 30) : GameObject(x_, y_, size_) { }
-	SnakeBody(const POINT& pos_, size_t size_ = 30) : SnakeBody(pos_.x, pos_.y, size_) { }
-	
-	~SnakeBody(){	
-		printf("SnakeBody dtor: pos[x: %d, y: %d]", _pos.x, _pos.y);
-		reset();
-	}
-	
-	
-	void draw(HDC hdc_, COLORREF color_) const { 
-		Painter::drawSquare(hdc_, _pos, _size, color_); 
-	}
-
-	void move(int dx_, int dy_) {
-		_pos.x += static_cast<LONG>(dx_ * _size);
-		_pos.y += static_cast<LONG>(dy_ * _size);
-	}
-
-};
-
-class Bait: GameObject {
-	friend class Game;
-	COLORREF _color = RGB(0, 255, 0);
-
-public:
-	void draw(const HDC hdc_) const { Painter::drawSquare(hdc_, _pos, _size, _color); }
-	
-	void reset() { 
-		_color = RGB(0, 255, 0); 
-	}
-};
-
-
-class Snake : GameObject
-{
-	friend class Game;
-	std::vector<SnakeBody> _body;
-	size_t _init_body_size = 3;
-	Direction _currentDirection = Direction::N;
-	size_t _speed = 100;
-	bool _canSetDirection = true; // prevent setDirection more than 1 per update;
-
-	void init(const int x_, const int y_) {
-		if (_init_body_size == 0) { throw std::exception("init_size must be > 0"); }
-		_body.emplace_back(x_, y_);
-		grow(_init_body_size - 1);
-		const auto& h = getHead();
-		POINT bodyPos = h.getPos();
+	void clear(Color c) override {
+		RECT cr;
+		GetClientRect(_hWnd, &cr);
+		fillRect(toRectI(cr), c);
 	}
 
-	void clear_body() { _body.clear(); }
-	
-public:
-	
-	Snake(int x_ = 0, int y_ = 0) : GameObject(x_, y_) {  init(x_, y_); }
-	Snake(const POINT pos_) : Snake(pos_.x, pos_.y) { }
-
-	const SnakeBody& getHead() const	{ return _body.front(); }
-	const SnakeBody& getTail() const	{ return _body.back();  }
-
-	void reset(const POINT pos_) {
-		GameObject::reset();
-		clear_body();
-		init(pos_.x, pos_.y);
-		_canSetDirection = true;
+	void fillRect(const RectI& r, Color c) override {
+		if (c.isTransparent()) return;
+		RECT rc = toRect(r);
+		SetDCBrushColor(_hdc, toColorRef(c));
+		FillRect(_hdc, &rc, (HBRUSH)GetStockObject(DC_BRUSH));
 	}
 
-	size_t getSpeed() { return _speed; }
-
-	void setSize() = delete;
-	size_t getSize() const { return _body.size(); };
-
-	bool isOppositeDirection(Direction d) const {
-		switch (d)
-		{
-			case Direction::N: { return _currentDirection == Direction::S; } break;
-			case Direction::E: { return _currentDirection == Direction::W; } break;
-			case Direction::S: { return _currentDirection == Direction::N; } break; 
-			case Direction::W: { return _currentDirection == Direction::E; } break;
-			default: { assert(false && "you should not be here."); } break;
+	void fillRects(const RectI* rects, size_t n, Color c) override {
+		if (c.isTransparent()) return;
+		SetDCBrushColor(_hdc, toColorRef(c)); // once per batch
+		HBRUSH brush = (HBRUSH)GetStockObject(DC_BRUSH);
+		for (size_t i = 0; i < n; i++) {
+			RECT rc = toRect(rects[i]);
+			FillRect(_hdc, &rc, brush);
 		}
-		return false;
 	}
 
-
-	void setDirection(Direction d) {
-		if (!_canSetDirection || isOppositeDirection(d)) return;
-		_currentDirection = d;
-		_canSetDirection = false; // wait move() to release;
-		
+	void frameRect(const RectI& r, Color c) override {
+		RECT rc = toRect(r);
+		SetDCBrushColor(_hdc, toColorRef(c));
+		FrameRect(_hdc, &rc, (HBRUSH)GetStockObject(DC_BRUSH));
 	}
 
-	const Direction& getCurrentDirection() const { return _currentDirection; }
-	Direction& getCurrentDirection()  { return getCurrentDirection(); }
+	void drawText(const RectI& r, const char* s, const TextStyle& style) override {
+		wchar_t ws[128] = { 0 };
+		for (int i = 0; s[i] && i < 127; i++) ws[i] = static_cast<wchar_t>(s[i]); // scene text is ASCII
 
-	POINT getCurrentDirectionAsVector() const {
-		POINT cd;
-		switch (_currentDirection)
+		UINT format = DT_VCENTER | DT_SINGLELINE;
+		switch (style.align)
 		{
-			case Direction::N: { cd.x = 0; cd.y = -1; } break;
-			case Direction::E: { cd.x = 1; cd.y = 0; } break;
-			case Direction::S: { cd.x = 0; cd.y = 1; } break;
-			case Direction::W: { cd.x = -1; cd.y = 0; } break;
-			default: { assert(false && "you should not be here"); } break;
+			case TextAlign::Left:	{ format |= DT_LEFT;   } break;
+			case TextAlign::Center:	{ format |= DT_CENTER; } break;
+			case TextAlign::Right:	{ format |= DT_RIGHT;  } break;
+			default: break;
 		}
-		return cd;
-	}
-
-	POINT getPos() const { return getHead().getPos(); }
-
-	POINT getNextPos() const {
-		POINT cd = getCurrentDirectionAsVector();
-		return getHead().getNextPos(cd.x, cd.y);
-	}
-
-	void move() {
-		SnakeBody& h = _body.front();
-		
-		// body follow
-		for (size_t i = _body.size() - 1; i > 0; i--) {
-			auto& dst = _body[i];
-			const auto & src = _body[i - 1];
-			dst.setPos(src.getPos());			
-		}
-
-		POINT cd = getCurrentDirectionAsVector();
-		h.move(cd.x, cd.y);
-		_canSetDirection = true;
-	}
-
-	void grow(const size_t n = 1) {
-		for (int i = 0; i < n; i++) {
-			_body.emplace_back(getTail().getPos());
-		}
-	}
-
-	void draw(const HDC& hdc, const COLORREF& _headColor, const COLORREF& _bodyColor) const {
-		for (int i = 1; i < _body.size(); i++) {
-			const SnakeBody& b = _body[i];
-			b.draw(hdc, _bodyColor); //draw body
-		}
-
-		getHead().draw(hdc, _headColor); //draw head, always on top;
-		
+		int savedDC = SaveDC(_hdc);
+		SetBkMode(_hdc, style.background.isTransparent() ? TRANSPARENT : OPAQUE);
+		Painter::drawMessage(_hWnd, _hdc, ws, toRect(r), toColorRef(style.background), toColorRef(style.text), style.size, format);
+		RestoreDC(_hdc, savedDC);
 	}
-
-	void onKeyUp()		{ setDirection(Direction::N); }
-	void onKeyRight()	{ setDirection(Direction::E); }
-	void onKeyDown()	{ setDirection(Direction::S); }
-	void onKeyLeft()	{ setDirection(Direction::W); }
 };
 
 enum class GameState {
@@ -466,8 +299,12 @@ struct GameLayout {
 	LayoutBox clientRect;
 	LayoutBox uiRect;
 	LayoutBox gameRect;
+	int cellSize = 30;
+	int nCellsPerSide = 20;
 
 	void initGameRect(int cell_size = 30, int n_cells_per_side = 20) {
+		cellSize = cell_size;
+		nCellsPerSide = n_cells_per_side;
 		gameRect.width = cell_size * n_cells_per_side;
 		gameRect.height = gameRect.width;
 	}
@@ -497,37 +334,74 @@ struct GameLayout {
 	RECT getUiRect() const { return uiRect.rect(); };
 	RECT rect() const { return clientRect.rect(); };
 
+	SceneLayout toSceneLayout() const {
+		SceneLayout l;
+		l.clientRect = toRectI(rect());
+		l.uiRect = toRectI(getUiRect());
+		l.gameRect = toRectI(getGameRect());
+		l.cellSize = cellSize;
+		return l;
+	}
+
 };
 
 class Game {
 
 private:
-	POINT _snake_init_pos{0, 0};
-	Snake _snake;
-	Bait _bait;
+	GameSim _sim;
+	ReplayRecorder _recorder;
+	Replay _lastReplay;
+	bool _archiveReplays = false; // 'R': append each finished game to the user's archive
+	char _archiveText[40] = ""; // outcome of the last archive attempt, for the UI bar
 	HWND hWnd = NULL;
 	HDC srcDC = NULL;
 	bool _isPause = false;
-	int score = 0;
 	time_t gameStart;
 	
 	Sprite _landingSprite;
-	COLORREF _snakeHeadColor = RGB(255, 0, 0); // red head
-	COLORREF _snakeBodyColor = RGB(128, 128, 128); //grey body
+	SceneStyle _style; // red head, grey body, green bait
+	SceneCache _uiShown; // score / time last sent to the UI bar, cells under the last drawMotion
+	FixedStep _clock; // ticks come from here, WM_PAINT only draws
+	InputQueue _input; // arrow keys, drained by the tick
+	bool _showLatency = false; // input->paint p50 / p99 in the UI bar
+	char _latencyText[32] = "";
+	bool _hasUnshownTurn = false; // a turn was applied and no WM_PAINT has shown it yet
+	LatencyStats::Clock::time_point _unshownInput{}, _unshownTick{};
+	bool _interpolate = true; // draw the snake between ticks (FixedStep::alpha)
+	enum class Pilot { Keys, Search, Cycle };
+	Pilot _pilotMode = Pilot::Keys; // who steers: the arrow keys or one of the policies below
+	Autopilot _pilot;
+	const HamiltonCycle* _cycle = nullptr; // of the current board, shared per board size
+	mutable DisplayList _frameList; // recorded and replayed by each paint, memory reused
+	HRGN _updateRgn = NULL; // WM_PAINT's update region and its rectangles, memory reused
+	std::vector<uint8_t> _regionData;
+	std::vector<RectI> _paintRects;
 	GameState _currentState = GameState::Landing; 
 	
 public:
-	//Game() = default;
-	Game(int x_ = 0, int y_ = 0) : _snake(x_, y_), _snake_init_pos{ x_, y_ }, _landingSprite(IDB_BITMAP1, IDB_BITMAP13) { srand((unsigned int) time(NULL)); };
-	Game(const POINT& pos_) : Game(pos_.x, pos_.y) { }
-	~Game() { if (srcDC) { DeleteDC(srcDC); } }
+	Game() : _landingSprite(IDR_TITLE_ATLAS) { };
+	~Game() {
+		if (srcDC) { DeleteDC(srcDC); }
+		if (_updateRgn) { DeleteObject(_updateRgn); }
+	}
 	GameLayout gameLayout;
 	
-	void setCurrentState(GameState state) { _currentState = state; }
+	static constexpr int kLandingFrameMs = 100; // title animation rate
+	static constexpr int kFrameMs = 16; // redraw rate while interpolating
+	static constexpr int kPausedPollMs = 100; // the UI bar clock still runs while paused
+
+	void setCurrentState(GameState state) {
+		_currentState = state;
+		_clock.reset(FixedStep::Clock::now());
+		_uiShown.nMotion = 0;
+		if (hWnd) { InvalidateRect(hWnd, nullptr, true); }
+	}
 	GameState getCurrentState() const { return _currentState; }
 	
 	void setHwnd(HWND hWnd_) { hWnd = hWnd_;}
-	Snake& getSnake() { return _snake; }
+	Snake& getSnake() { return _sim.getSnake(); }
+	const GameSim& getSim() const { return _sim; }
+	const Replay& getLastReplay() const { return _lastReplay; }
 
 
 	void init(HWND hWnd_) { 
@@ -545,129 +419,208 @@ public:
 
 	void restart(GameState dstGameState = GameState::Landing) {
 		gameStart = time(nullptr);
-		RECT gr = gameRect();
-		_snake_init_pos.x = (gr.right - gr.left) / 2; 
-		_snake_init_pos.y = (gr.bottom - gr.top) / 2; 
-		POINT adjPos = adjustedPosition(_snake_init_pos, _snake.getHead());
- 		_snake.reset(adjPos);
-		placeBait();
-		score = 0;
+		int n = gameLayout.nCellsPerSide;
+		_sim.reset(n, n, static_cast<uint64_t>(gameStart));
+		_input.clear();
+		_recorder.begin(_sim);
+		_archiveText[0] = '\0';
 		setCurrentState(dstGameState);
 	}
 
-	void getGameDuration(wchar_t* const buff) const {
-		if (!buff) return;
-		int n_s   = (int) (time(nullptr) - gameStart);
-		int n_min = (int) n_s / 60;
-		n_s %= 60;
-		char c = n_s % 2 ? ' ' : ':'; // flashing
-		swprintf(buff, 20, L"%02d%c%02d", n_min, c, n_s);
-	}
-
-	void update() {
+	// Runs whatever ticks are due since the last call and invalidates what they changed;
+	// returns how long the message loop may wait for input before calling again, in ms.
+	DWORD frame() {
+		_clock.beginFrame(FixedStep::Clock::now());
 		switch (_currentState)
 		{
-			case GameState::None: break;
-			case GameState::Landing: {update_Landing(); }break;
-			case GameState::GamePlay: { update_GamePlay(); } break;
-			case GameState::GameOver: break;
-			case GameState::Ranking: break;
-			default:
-				break;
+			case GameState::Landing: {
+				std::chrono::milliseconds step(kLandingFrameMs);
+				while (_clock.tick(step)) { update_Landing(); }
+				return toWaitMs(_clock.untilNextTick(step));
+			}
+			case GameState::GamePlay: {
+				std::chrono::milliseconds step = tickDuration();
+				if (_isPause) { _clock.hold(); }
+				while (_clock.tick(step)) {
+					update_GamePlay();
+					if (_currentState != GameState::GamePlay) { return INFINITE; }
+					step = tickDuration(); // the snake speeds up as it grows
+				}
+				if (_showLatency) { LatencyStats::global().formatShort(_latencyText, sizeof(_latencyText)); }
+				invalidateDirty();
+				DWORD wait = toWaitMs(_clock.untilNextTick(step));
+				if (_interpolate && !_isPause && wait > static_cast<DWORD>(kFrameMs)) { wait = kFrameMs; }
+				return _isPause ? static_cast<DWORD>(kPausedPollMs) : wait;
+			}
+			case GameState::None:
+			case GameState::GameOver:
+			case GameState::Ranking:
+			default: return INFINITE; // nothing moves until a key is pressed
+		}
+	}
+
+	std::chrono::milliseconds tickDuration() const { return std::chrono::milliseconds(_sim.getSnake().getSpeed()); }
+
+	static DWORD toWaitMs(FixedStep::Duration d) {
+		return static_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(d).count()); // waking early would spin
+	}
+
+	// runs the simulation as fast as it goes, still drawing about 60 frames a second
+	void toggleUnthrottled() {
+		_clock.setUnthrottled(!_clock.unthrottled());
+		_clock.reset(FixedStep::Clock::now());
+	}
+
+	void toggleInterpolation() {
+		_interpolate = !_interpolate;
+		if (hWnd) { InvalidateRect(hWnd, nullptr, true); }
+	}
+
+	// %LOCALAPPDATA%\Snake\replays.snka; empty when the variable is not set
+	static std::filesystem::path replayArchivePath() {
+		wchar_t dir[MAX_PATH];
+		DWORD n = GetEnvironmentVariableW(L"LOCALAPPDATA", dir, MAX_PATH);
+		if (n == 0 || n >= MAX_PATH) { return std::filesystem::path(); }
+		return std::filesystem::path(dir) / L"Snake" / L"replays.snka";
+	}
+
+	void toggleReplayArchive() {
+		_archiveReplays = !_archiveReplays;
+		snprintf(_archiveText, sizeof(_archiveText), "archiving replays: %s", _archiveReplays ? "on" : "off");
+		if (hWnd) { RECT ur = uiRect(); InvalidateRect(hWnd, &ur, false); }
+	}
+
+	// only when opted in; whether it worked shows in the UI bar of the game over screen
+	void archiveLastReplay() {
+		_archiveText[0] = '\0';
+		if (!_archiveReplays) { return; }
+		const std::filesystem::path path = replayArchivePath();
+		std::error_code ec;
+		if (!path.empty()) { std::filesystem::create_directories(path.parent_path(), ec); }
+		ReplayArchiveWriter archive;
+		uint32_t durationMs = static_cast<uint32_t>(time(nullptr) - gameStart) * 1000;
+		bool ok = !path.empty() && !ec && archive.open(path) && archive.append(_lastReplay, durationMs) && archive.flush();
+		if (ok) {
+			snprintf(_archiveText, sizeof(_archiveText), "replay %zu saved", archive.count());
+		}
+		else {
+			snprintf(_archiveText, sizeof(_archiveText), "replay NOT saved");
+			std::wstring msg = L"Snake: could not write replay archive '" + path.wstring() + L"'\n";
+			OutputDebugStringW(msg.c_str());
 		}
 	}
 
 	void update_Landing() {
 		_landingSprite.nextFrame();
-		InvalidateRect(hWnd, nullptr, true);
+		RECT sr = Painter::titleSpriteRect(hWnd, _landingSprite); // the frame covers it, no erase
+		InvalidateRect(hWnd, &sr, false);
 	}
 
+	// one tick; frame() invalidates once for all the ticks it ran
 	void update_GamePlay() {
-		if (_isPause) {
-			InvalidateRect(hWnd, nullptr, true);
+		if (_pilotMode != Pilot::Keys) {
+			_input.clear();
+			_sim.step(_pilotMode == Pilot::Cycle ? CyclePilot(*_cycle).decide(_sim) : _pilot.decide(_sim));
+			endTick();
 			return;
 		}
-		_snake.move();
-		if (isGameOver()) {
-			_currentState = GameState::GameOver;
-			InvalidateRect(hWnd, nullptr, true);
-			return;
-		}
-		
-		if (_snake.getHead().isCollided(_bait)) {
-			_snake.grow(1);
-			score++;
-			placeBait();
+		InputCommand turn;
+		bool turned = _input.nextTurn(_sim.getSnake(), turn);
+		if (turned && LatencyStats::kEnabled) {
+			LatencyStats::Clock::time_point now = LatencyStats::Clock::now();
+			recordLatency(LatencyStage::InputToTick, turn.time, now);
+			if (!_hasUnshownTurn) { _unshownInput = turn.time; _unshownTick = now; _hasUnshownTurn = true; }
 		}
-		
-		InvalidateRect(hWnd, nullptr, true);
+		_sim.step(turned ? static_cast<Action>(turn.direction) : Action::None);
+		endTick();
 	}
 
-	bool isGameOver() const {
-		
-		const SnakeBody& h = _snake.getHead();
-		for (int i = 1; i < _snake._body.size(); i++) {
-			const SnakeBody& b = _snake._body[i];
-			if (h.isCollided(b)) return true; 
+	void endTick() {
+		_recorder.onStep(_sim);
+		if (_sim.isOver()) {
+			_lastReplay = _recorder.finish(_sim);
+			archiveLastReplay();
+			setCurrentState(GameState::GameOver);
 		}
-		RECT gr = gameRect();
+	}
 
-		if (_snake._currentDirection == Direction::N || _snake._currentDirection == Direction::W)
-			return !PtInRect(&gr, _snake.getPos());
-		return !PtInRect(&gr, _snake.getNextPos());
+	// only the cells the last ticks changed, the cells the snake is moving through between
+	// ticks, and the UI bar when its text changes; drawGamePlay repaints the rectangles of
+	// WM_PAINT's update region
+	void invalidateDirty() {
+		const DirtyCells& dirty = _sim.dirty();
+		SceneLayout l = gameLayout.toSceneLayout();
+		if (dirty.all()) {
+			InvalidateRect(hWnd, nullptr, true);
+		}
+		else {
+			for (int i = 0; i < dirty.size(); i++) {
+				invalidateCell(l, dirty[i]);
+			}
+		}
+		_sim.clearDirty();
+
+		SceneState st = sceneState();
+		Cell moving[2];
+		int nMoving = st.tickAlpha > 0.0f ? Scene::motionCells(_sim, moving) : 0;
+		for (int i = 0; i < _uiShown.nMotion; i++) { invalidateCell(l, _uiShown.motion[i]); }
+		for (int i = 0; i < nMoving; i++) { invalidateCell(l, moving[i]); _uiShown.motion[i] = moving[i]; }
+		_uiShown.nMotion = nMoving;
+
+		if (_uiShown.uiChanged(_sim.score(), st.elapsedSec, st.status)) {
+			RECT ur = uiRect();
+			InvalidateRect(hWnd, &ur, false);
+			_uiShown.setUi(_sim.score(), st.elapsedSec, st.status);
+		}
 	}
 
-	bool isValidBait(const Bait& bait_) const {
-		POINT rb_pt{
-			bait_.hitBox().right,
-			bait_.hitBox().bottom
-		};
-		
-		RECT gr = gameRect();
-		
-		if (!PtInRect(&gr, rb_pt)) 
-			return false;
+	// after EndPaint: the turn applied by the last ticks is on screen now
+	void onPresented() {
+		if (!LatencyStats::kEnabled || !_hasUnshownTurn) return;
+		LatencyStats::Clock::time_point now = LatencyStats::Clock::now();
+		recordLatency(LatencyStage::TickToPaint, _unshownTick, now);
+		recordLatency(LatencyStage::InputToPaint, _unshownInput, now);
+		_hasUnshownTurn = false;
+	}
 
-		for (const auto& sb : _snake._body) {
-			if (bait_.isCollided(sb)) 
-				return false;
+	// keys -> search autopilot -> Hamiltonian cycle -> keys; the cycle pilot assumes it has
+	// steered since the start, so it only takes over at the start of a game
+	void toggleAutopilot() {
+		int n = gameLayout.nCellsPerSide;
+		if (_pilotMode == Pilot::Keys) { _pilotMode = Pilot::Search; return; }
+		if (_pilotMode == Pilot::Search && _sim.ticks() == 0 && HamiltonCycle::exists(n, n)) {
+			_cycle = &HamiltonCycle::forBoard(n, n);
+			_pilotMode = Pilot::Cycle;
+			return;
 		}
-		return true;
+		_pilotMode = Pilot::Keys;
 	}
 
-	void placeBaitWithType(Bait& bait_) {
-		RECT gr = gameRect();
-		int upperLimit = 1000;
-		POINT randomPoint{ 0, 0 };
-		
-		
-		for (int c = 0; c < upperLimit; c++) {
-			randomPoint = Util::getRandomPointInRect(gr);
-			randomPoint = adjustedPosition(randomPoint, _bait);
-			_bait.setPos(randomPoint);
-			if (isValidBait(_bait)) return;
-		}
-		assert(false && "sth is wrong");
+	void toggleLatency() {
+		_showLatency = !_showLatency;
+		_latencyText[0] = '\0';
 	}
 
-	POINT adjustedPosition(POINT pos, const GameObject& o) const {
-		int r = static_cast<int>(o.getSize());
-		int rx = pos.x % r;
-		int ry = pos.y % r;
-		pos.x -= rx;
-		pos.y -= ry;
-		return pos;
+	// all stages to the debugger output
+	void dumpLatency() const {
+		char buff[256];
+		LatencyStats::global().format(buff, sizeof(buff));
+		OutputDebugStringA(buff);
 	}
-	
-	void placeBait() { placeBaitWithType(_bait); }
 
-	void draw(HDC hdc_) const {
+	void invalidateCell(const SceneLayout& l, const Cell& c) {
+		if (!_sim.isInside(c)) return;
+		RECT cr = toRect(l.cellRect(c));
+		InvalidateRect(hWnd, &cr, false);
+	}
+
+	void draw(HDC hdc_, const RECT& paintRect) const {
 		
 		switch (_currentState)
 		{		
 			case GameState::None:			{ throw std::exception("GameState::None"); }	break;
 			case GameState::Landing:		{ drawTitle(hdc_); }							break;
-			case GameState::GamePlay:		{ drawGamePlay(hdc_); }							break;
+			case GameState::GamePlay:		{ drawGamePlay(hdc_, paintRect); }				break;
 			case GameState::GameOver:		{ drawGameOver(hdc_); }							break;
 			case GameState::Ranking:		{ drawRanking(hdc_); }							break;
 			default:						{ throw std::exception("Unknown GameState"); }	break;
@@ -676,30 +629,48 @@ public:
 
 	
 
-	void drawGamePlay(HDC hdc_) const {
-		gameLayout.draw(hdc_);
-		drawGamePlayUi(hdc_);
-		_snake.draw(hdc_, _snakeHeadColor, _snakeBodyColor);
-		_bait.draw(hdc_);
-		if (_isPause) { drawPause(hdc_); }
+	SceneState sceneState() const {
+		SceneState st;
+		st.isPaused = _isPause;
+		st.elapsedSec = (int) (time(nullptr) - gameStart);
+		if (_interpolate && !_isPause && _currentState == GameState::GamePlay) { st.tickAlpha = _clock.alpha(tickDuration()); }
+		if (_showLatency) { st.status = _latencyText; }
+		else if (_archiveText[0]) { st.status = _archiveText; }
+		return st;
+	}
+
+	// WM_PAINT, before BeginPaint validates the window: the update region as its rectangles,
+	// so dirty cells far apart repaint on their own and not the whole box around them
+	void captureUpdateRegion() {
+		_paintRects.clear();
+		if (!_updateRgn) { _updateRgn = CreateRectRgn(0, 0, 0, 0); }
+		if (GetUpdateRgn(hWnd, _updateRgn, FALSE) <= NULLREGION) { return; } // ERROR or empty
+		DWORD bytes = GetRegionData(_updateRgn, 0, nullptr);
+		if (bytes == 0) { return; }
+		_regionData.resize(bytes);
+		RGNDATA* data = reinterpret_cast<RGNDATA*>(_regionData.data());
+		if (GetRegionData(_updateRgn, bytes, data) == 0) { return; }
+		const RECT* rects = reinterpret_cast<const RECT*>(data->Buffer);
+		for (DWORD i = 0; i < data->rdh.nCount; i++) { _paintRects.push_back(toRectI(rects[i])); }
+	}
+
+	void drawGamePlay(HDC hdc_, const RECT& paintRect) const {
+		_frameList.reset();
+		if (_paintRects.empty()) { // no region captured: the bounding rect
+			Scene::drawRegion(_frameList, gameLayout.toSceneLayout(), _style, _sim, sceneState(), toRectI(paintRect));
+		}
+		else {
+			Scene::drawRegion(_frameList, gameLayout.toSceneLayout(), _style, _sim, sceneState(), _paintRects.data(), static_cast<int>(_paintRects.size()));
+		}
+		GdiRenderer r(hWnd, hdc_);
+		_frameList.replay(r);
 	}
 
-	void drawGamePlayUi(const HDC& hdc_) const
-	{
-		RECT ur = uiRect();
-		int xoffset = 10;
-		ur.left += xoffset;
-		ur.right -= xoffset;
-		wchar_t s[20] = { 0 };
-		getGameDuration(s);
-		std::wstring ws_score = L"Score: " + std::to_wstring(score);
-		std::wstring ws_gtime = s;
-
-		Painter::drawMessage(hWnd, hdc_, ws_score.data(), ur, RGB(127, 255, 127), RGB(0, 0, 0), NULL, DT_VCENTER | DT_SINGLELINE | DT_LEFT);
-		Painter::drawMessage(hWnd, hdc_, ws_gtime.data(), ur, RGB(127, 127, 127), RGB(0, 0, 0), NULL, DT_VCENTER | DT_SINGLELINE | DT_RIGHT);
+	void togglePause() {
+		_isPause = !_isPause;
+		_uiShown.nMotion = 0; // full repaint below
+		InvalidateRect(hWnd, nullptr, true); // the overlay comes and goes
 	}
-
-	void togglePause() { _isPause = !_isPause; }
 	
 	void onEsc() {
 		if (_currentState == GameState::GameOver) {
@@ -707,6 +678,11 @@ public:
 		}
 	}
 	
+	// arrow keys; queued, the next ticks apply them one turn each
+	void onDirection(Direction d) {
+		if (_currentState == GameState::GamePlay) { _input.push(d); }
+	}
+
 	void onSpace() {
 		switch (_currentState)
 		{
@@ -724,25 +700,13 @@ public:
 	}
 
 	
-	void drawPause(HDC hdc_) const {
-		RECT cr = gameLayout.clientRect.rect();
-		Painter::drawMessage(hWnd, hdc_, L"Pause", cr, RGB(127, 127, 127), RGB(0, 0, 0));
-		cr.top += (cr.bottom - cr.top) / 4;
-		Painter::drawMessage(hWnd, hdc_, L"Press <SPACE> to resume", cr, RGB(127, 127, 127), RGB(0, 0, 0));
-	}
-
 	void drawTitle(HDC hdc_) const { Painter::drawTitle(hWnd, hdc_, srcDC, _landingSprite); }
 
 	void drawGameOver(HDC hdc_) const {
-		drawGamePlay(hdc_);
-		
-		RECT cr = gameLayout.clientRect.rect();
-		Painter::drawMessage(hWnd, hdc_, L"Game Over", cr, RGB(255, 0, 0), RGB(255, 255, 255));
-		cr.top += (cr.bottom - cr.top) / 3;
-		Painter::drawMessage(hWnd, hdc_, L"Press <SPACE> To continue", cr, RGB(127, 127, 127), RGB(0, 0, 0));
-		cr.top += (cr.bottom - cr.top) / 5;
-		Painter::drawMessage(hWnd, hdc_, L"Press <ESC> To restart", cr, RGB(127, 127, 127), RGB(0, 0, 0));
-		
+		_frameList.reset();
+		Scene::drawGameOver(_frameList, gameLayout.toSceneLayout(), _style, _sim, sceneState());
+		GdiRenderer r(hWnd, hdc_);
+		_frameList.replay(r);
 	}
 
 	void drawRanking(HDC hdc_) const {
@@ -0,0 +1,223 @@
+#include "ArenaSim.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+ArenaSim::ArenaSim(const ArenaConfig& config_) : _config(config_) {
+	if (config_.width <= 0 || config_.height <= 0) { throw std::invalid_argument("board size must be > 0"); }
+	if (config_.width > kMaxBoardSide || config_.height > kMaxBoardSide) { throw std::invalid_argument("board side too large"); }
+	if (config_.nSnakes == 0 || config_.nSnakes >= kBaitBit - 1) { throw std::invalid_argument("arena needs between 1 and 2^31 - 2 snakes"); }
+	if (config_.nBaits >= kBaitBit) { throw std::invalid_argument("too many baits"); }
+	if (config_.initialLength == 0) { throw std::invalid_argument("initialLength must be > 0"); }
+	_owner.assign(static_cast<size_t>(config_.width) * static_cast<size_t>(config_.height), kFree);
+	_snakes.resize(config_.nSnakes);
+	for (ArenaSnake& s : _snakes) s.body.reset(16);
+	_baits.assign(config_.nBaits, kNoBait);
+	_dying.reserve(config_.nSnakes);
+	_waiting.reserve(config_.nSnakes);
+	_emptyBaits.reserve(config_.nBaits);
+	reset(config_.seed);
+}
+
+void ArenaSim::reset(uint64_t seed_) {
+	_seed = seed_;
+	_rng.seed(seed_);
+	_ticks = 0;
+	_nAlive = 0;
+	_last = TickStats();
+	std::fill(_owner.begin(), _owner.end(), kFree);
+	for (ArenaSnake& s : _snakes) {
+		s.body.clear();
+		s.pending = 0;
+		s.score = 0;
+		s.deaths = 0;
+		s.headTick = 0;
+		s.alive = false;
+	}
+	_waiting.clear();
+	_emptyBaits.clear();
+	for (uint32_t i = 0; i < _snakes.size(); i++) {
+		if (!spawn(i)) _waiting.push_back(i);
+	}
+	for (uint32_t b = 0; b < _baits.size(); b++) {
+		_baits[b] = kNoBait;
+		if (!placeBait(b)) _emptyBaits.push_back(b);
+	}
+}
+
+// uniformly random among the free cells by rejection: fine while the arena is mostly empty,
+// and a crowded one just retries next tick
+bool ArenaSim::randomFreeCell(Cell& out) {
+	for (int t = 0; t < kPlaceTries; t++) {
+		Cell c{ static_cast<int>(_rng.below(static_cast<uint32_t>(_config.width))), static_cast<int>(_rng.below(static_cast<uint32_t>(_config.height))) };
+		if (_owner[index(c)] == kFree) {
+			out = c;
+			return true;
+		}
+	}
+	return false;
+}
+
+// one segment plus initialLength - 1 pending, heading onto a free cell when there is one
+bool ArenaSim::spawn(uint32_t i) {
+	Cell c;
+	if (!randomFreeCell(c)) return false;
+	ArenaSnake& s = _snakes[i];
+	const uint32_t d0 = _rng.below(4);
+	s.direction = static_cast<Direction>(d0);
+	for (uint32_t k = 0; k < 4; k++) {
+		const Direction d = static_cast<Direction>((d0 + k) & 3);
+		const Cell v = directionAsVector(d);
+		if (isFree(Cell{ c.x + v.x, c.y + v.y })) { s.direction = d; break; }
+	}
+	s.body.clear();
+	s.body.pushFront(c);
+	s.pending = _config.initialLength - 1;
+	s.score = 0;
+	s.headTick = _ticks;
+	s.alive = true;
+	_owner[index(c)] = i + 1;
+	_nAlive++;
+	return true;
+}
+
+bool ArenaSim::placeBait(uint32_t slot) {
+	Cell c;
+	if (!randomFreeCell(c)) return false;
+	_baits[slot] = c;
+	_owner[index(c)] = kBaitBit | slot;
+	return true;
+}
+
+void ArenaSim::kill(uint32_t i) {
+	_snakes[i].alive = false;
+	_snakes[i].deaths++;
+	_nAlive--;
+	_dying.push_back(i);
+}
+
+void ArenaSim::removeBody(uint32_t i) {
+	ArenaSnake& s = _snakes[i];
+	for (size_t k = 0; k < s.body.size(); k++) {
+		uint32_t& o = _owner[index(s.body[k])];
+		if (o == i + 1) o = kFree;
+	}
+	s.body.clear();
+	s.pending = 0;
+}
+
+void ArenaSim::step(const Action* actions) {
+	_ticks++;
+	_last = TickStats();
+	const uint32_t n = static_cast<uint32_t>(_snakes.size());
+
+	for (uint32_t i = 0; i < n; i++) {
+		ArenaSnake& s = _snakes[i];
+		if (!s.alive) continue;
+		const Action a = actions[i];
+		if (a != Action::None && static_cast<Direction>(a) != oppositeDirection(s.direction)) s.direction = static_cast<Direction>(a);
+		if (s.pending > 0) {
+			s.pending--;
+		} else {
+			_owner[index(s.body.back())] = kFree;
+			s.body.popBack();
+		}
+	}
+
+	for (uint32_t i = 0; i < n; i++) {
+		ArenaSnake& s = _snakes[i];
+		if (!s.alive) continue;
+		const Cell v = directionAsVector(s.direction);
+		const Cell next{ s.body.front().x + v.x, s.body.front().y + v.y };
+		if (!isInside(next)) {
+			_last.diedWall++;
+			kill(i);
+			continue;
+		}
+		uint32_t& o = _owner[index(next)];
+		if (o & kBaitBit) {
+			_baits[o & ~kBaitBit] = kNoBait;
+			_emptyBaits.push_back(o & ~kBaitBit);
+			s.pending++;
+			s.score++;
+			_last.ate++;
+		} else if (o != kFree) {
+			const uint32_t j = o - 1;
+			const ArenaSnake& other = _snakes[j];
+			if (j != i && other.alive && other.headTick == _ticks && other.body.front() == next) {
+				_last.diedHeadOn += 2;
+				kill(j);
+			} else {
+				_last.diedBody++;
+			}
+			kill(i);
+			continue;
+		}
+		if (s.body.full()) s.body.reserve(s.body.capacity() * 2);
+		s.body.pushFront(next);
+		o = i + 1;
+		s.headTick = _ticks;
+		_last.moved++;
+	}
+
+	for (uint32_t i : _dying) {
+		removeBody(i);
+		if (_config.respawn) _waiting.push_back(i);
+	}
+	_dying.clear();
+
+	// slots and snakes that found no free cell stay listed, first in line next tick
+	size_t kept = 0;
+	for (uint32_t b : _emptyBaits) {
+		if (!placeBait(b)) _emptyBaits[kept++] = b;
+	}
+	_emptyBaits.resize(kept);
+	kept = 0;
+	for (uint32_t i : _waiting) {
+		if (spawn(i)) _last.spawned++;
+		else _waiting[kept++] = i;
+	}
+	_waiting.resize(kept);
+}
+
+void ArenaSim::setSnake(size_t i, const std::vector<Cell>& body_, Direction d) {
+	if (i >= _snakes.size()) { throw std::invalid_argument("no such snake"); }
+	if (body_.empty()) { throw std::invalid_argument("snake body must not be empty"); }
+	const uint32_t id = static_cast<uint32_t>(i) + 1;
+	std::vector<PackedCell> cells;
+	cells.reserve(body_.size());
+	for (size_t k = 0; k < body_.size(); k++) {
+		const Cell& c = body_[k];
+		if (!isInside(c) || (_owner[index(c)] != kFree && _owner[index(c)] != id)) { throw std::invalid_argument("invalid snake body"); }
+		if (k > 0 && std::abs(c.x - body_[k - 1].x) + std::abs(c.y - body_[k - 1].y) != 1) { throw std::invalid_argument("snake body is not connected"); }
+		cells.push_back(packCell(c));
+	}
+	std::sort(cells.begin(), cells.end());
+	if (std::adjacent_find(cells.begin(), cells.end()) != cells.end()) { throw std::invalid_argument("invalid snake body"); }
+
+	ArenaSnake& s = _snakes[i];
+	s.body.reserve(body_.size());
+	if (s.alive) {
+		removeBody(id - 1);
+	} else {
+		_waiting.erase(std::remove(_waiting.begin(), _waiting.end(), id - 1), _waiting.end());
+		_nAlive++;
+	}
+	for (const Cell& c : body_) {
+		s.body.pushBack(c);
+		_owner[index(c)] = id;
+	}
+	s.pending = 0;
+	s.score = 0;
+	s.headTick = _ticks;
+	s.direction = d;
+	s.alive = true;
+}
+
+size_t ArenaSim::memoryBytes() const {
+	size_t bytes = _owner.capacity() * sizeof(uint32_t) + _snakes.capacity() * sizeof(ArenaSnake)
+		+ _baits.capacity() * sizeof(Cell)
+		+ (_dying.capacity() + _waiting.capacity() + _emptyBaits.capacity()) * sizeof(uint32_t);
+	for (const ArenaSnake& s : _snakes) bytes += s.body.capacity() * sizeof(Cell);
+	return bytes;
+}
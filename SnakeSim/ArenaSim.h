@@ -0,0 +1,128 @@
+#pragma once
+
+// Arena mode: N snakes and M baits on one board, every snake steered by its own action each
+// tick. All collisions go through one ownership grid (a uint32 per cell: free, the snake
+// whose body covers it, or the bait slot lying on it), so a moved head costs one grid read
+// whatever the number of snakes; nothing is tested pair by pair.
+//
+// A tick resolves in a fixed order, passes 1 to 3 by ascending snake id:
+//	1. turns (opposite turns ignored, as in GameSim)
+//	2. every tail that is not growing leaves, so a head may follow any tail, its own or not
+//	3. heads enter: off the board or onto a body kills; onto a head that entered this tick
+//	   kills both (head-on); onto a bait eats it
+//	4. the dead leave the board, whole bodies
+//	5. missing baits and, with respawn on, dead snakes come back on random free cells, in
+//	   the order they were eaten and died
+// Given the seed and the actions the outcome is the same on every run. Work is linear in the
+// live heads plus the bodies of the snakes that died.
+
+#include "SimTypes.h"
+#include "RingBuffer.h"
+#include "Rng.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct ArenaConfig {
+	int width = 256;
+	int height = 256;
+	uint32_t nSnakes = 16;
+	uint32_t nBaits = 32;			// kept on the board while free cells can be found
+	uint32_t initialLength = 3;		// a head plus pending segments, as in GameSim
+	bool respawn = true;			// a dead snake is back on the board the same tick
+	uint64_t seed = 0;
+};
+
+class ArenaSim {
+public:
+	static constexpr int kMaxBoardSide = 32767;
+	static constexpr uint32_t kFree = 0;				// owner(): free cell
+	static constexpr uint32_t kBaitBit = 0x80000000u;	// owner(): kBaitBit | bait slot
+	static constexpr int kPlaceTries = 64;				// random cells tried per placement and tick
+
+	struct TickStats {
+		uint32_t moved = 0;
+		uint32_t ate = 0;
+		uint32_t diedWall = 0;
+		uint32_t diedBody = 0;
+		uint32_t diedHeadOn = 0;	// counts both snakes
+		uint32_t spawned = 0;
+	};
+
+	explicit ArenaSim(const ArenaConfig& config_ = ArenaConfig());
+
+	void reset(uint64_t seed_);
+
+	// actions: nSnakes() entries, None keeps the direction; dead snakes' entries are ignored
+	void step(const Action* actions);
+
+	// Replaces snake i, alive or not, with the given segments (head first) and nothing
+	// pending, e.g. to set up a collision. Segments must be on the board, distinct,
+	// 4-connected and on cells that are free or snake i's own (no bait). Throws
+	// std::invalid_argument with the arena untouched.
+	void setSnake(size_t i, const std::vector<Cell>& body_, Direction d);
+
+	bool isInside(const Cell& c) const { return c.x >= 0 && c.y >= 0 && c.x < _config.width && c.y < _config.height; }
+	// snake id + 1, kBaitBit | slot or kFree
+	uint32_t owner(const Cell& c) const { return _owner[index(c)]; }
+	// on the board and neither body nor head (bait is free to move onto)
+	bool isFree(const Cell& c) const { return isInside(c) && (_owner[index(c)] == kFree || (_owner[index(c)] & kBaitBit)); }
+
+	bool		isAlive(size_t i)		const { return _snakes[i].alive; }
+	Cell		getHead(size_t i)		const { return _snakes[i].body.front(); }
+	Cell		getSegment(size_t i, size_t k) const { return _snakes[i].body[k]; }
+	size_t		nSegments(size_t i)		const { return _snakes[i].body.size(); }
+	size_t		length(size_t i)		const { return _snakes[i].body.size() + _snakes[i].pending; }
+	Direction	direction(size_t i)		const { return _snakes[i].direction; }
+	uint32_t	score(size_t i)			const { return _snakes[i].score; }		// bait eaten, this life
+	uint32_t	deaths(size_t i)		const { return _snakes[i].deaths; }
+	bool		isOppositeDirection(size_t i, Direction d) const { return oppositeDirection(d) == _snakes[i].direction; }
+
+	// bait slots; a slot with hasBait() false is waiting for a free cell
+	size_t		nBaitSlots()			const { return _baits.size(); }
+	bool		hasBait(size_t slot)	const { return _baits[slot].x >= 0; }
+	Cell		getBait(size_t slot)	const { return _baits[slot]; }
+
+	const ArenaConfig& config()		const { return _config; }
+	int				width()			const { return _config.width; }
+	int				height()		const { return _config.height; }
+	size_t			nSnakes()		const { return _snakes.size(); }
+	size_t			nAlive()		const { return _nAlive; }
+	uint64_t		ticks()			const { return _ticks; }
+	uint64_t		seed()			const { return _seed; }
+	const TickStats& lastTick()		const { return _last; }
+	size_t			memoryBytes()	const;
+
+private:
+	struct ArenaSnake {
+		RingBuffer<Cell> body;		// front is the head, doubles when full
+		uint32_t pending = 0;		// segments still to unfold
+		uint32_t score = 0;
+		uint32_t deaths = 0;
+		uint64_t headTick = 0;		// tick the head last entered a cell, for head-on
+		Direction direction = Direction::N;
+		bool alive = false;
+	};
+
+	static constexpr Cell kNoBait{ -1, -1 };
+
+	ArenaConfig _config;
+	uint64_t _seed = 0;
+	uint64_t _ticks = 0;
+	size_t _nAlive = 0;
+	Rng _rng;
+	std::vector<uint32_t> _owner;		// row major
+	std::vector<ArenaSnake> _snakes;
+	std::vector<Cell> _baits;			// kNoBait: slot empty
+	std::vector<uint32_t> _dying;		// ids killed this tick, cleared in pass 4
+	std::vector<uint32_t> _waiting;		// dead ids to respawn, in order of death
+	std::vector<uint32_t> _emptyBaits;	// slots to refill, in order of eating
+	TickStats _last;
+
+	size_t index(const Cell& c) const { return static_cast<size_t>(c.y) * static_cast<size_t>(_config.width) + static_cast<size_t>(c.x); }
+	bool randomFreeCell(Cell& out);
+	bool spawn(uint32_t i);
+	bool placeBait(uint32_t slot);
+	void kill(uint32_t i);
+	void removeBody(uint32_t i);
+};
@@ -0,0 +1,174 @@
+#include "Autopilot.h"
+#include <algorithm>
+
+bool Autopilot::sync(const GameSim& sim) {
+	const Snake& s = sim.getSnake();
+	const int64_t t = static_cast<int64_t>(sim.ticks());
+	const bool sameBoard = sim.width() == _width && sim.height() == _height;
+	if (!sameBoard) {
+		_width = sim.width();
+		_height = sim.height();
+		_stride = _width + 2;
+		_step[0] = -_stride;
+		_step[1] = 1;
+		_step[2] = _stride;
+		_step[3] = -1;
+		size_t area = static_cast<size_t>(_width) * static_cast<size_t>(_height);
+		size_t n = static_cast<size_t>(_stride) * static_cast<size_t>(_height + 2);
+		_enteredAt.assign(n, kWall);
+		_seen.assign(n, 0);
+		_dist.assign(n, 0);
+		_via.assign(n, 0);
+		_queue.assign(n, 0);
+		_pathCells.assign(area, 0);
+		_pathSaved.assign(area, 0);
+		_plan.assign(area, 0);
+		_stamp = 0;
+	}
+
+	bool continued = sameBoard && _sim == &sim;
+	if (continued && t == _tick && s.getHead() == _head) {
+		// asked again within the same tick
+	}
+	else if (continued && t == _tick + 1 && s.nSegments() > 1 && s.getSegment(1) == _head) {
+		_enteredAt[index(s.getHead())] = t; // one tick on: only the head is new
+	}
+	else { // first call, new game or a snake set up from outside
+		for (int y = 0; y < _height; y++) {
+			std::fill_n(_enteredAt.begin() + index(Cell{ 0, y }), _width, kLongFree);
+		}
+		for (size_t k = 0; k < s.nSegments(); k++) {
+			_enteredAt[index(s.getSegment(k))] = t - static_cast<int64_t>(k);
+		}
+		continued = false;
+	}
+	_sim = &sim;
+	_tick = t;
+	_head = s.getHead();
+	_nSegments = static_cast<int64_t>(s.nSegments());
+	_length = static_cast<int64_t>(s.nSegments() + s.getPendingGrowth());
+	return continued;
+}
+
+int Autopilot::search(uint32_t from, int t0, Goal goal, uint32_t bait) {
+	if (goal == Goal::Tail && t0 > 0 && freeIn(from) > 0) return t0; // stepping right into the tail's cell
+	if (++_stamp == 0) { // wrapped: old stamps could match again
+		std::fill(_seen.begin(), _seen.end(), 0u);
+		_stamp = 1;
+	}
+
+	size_t head = 0;
+	size_t tail = 0;
+	_queue[tail++] = from;
+	_seen[from] = _stamp;
+	_dist[from] = t0;
+	int reached = 1;
+
+	while (head < tail) {
+		const uint32_t i = _queue[head++];
+		const int d = _dist[i] + 1;
+		for (int k = 0; k < 4; k++) {
+			const uint32_t j = static_cast<uint32_t>(static_cast<int>(i) + _step[k]);
+			if (_seen[j] == _stamp) continue;
+			const int64_t f = freeIn(j);
+			if (f > d) continue; // still body (or wall) when we would get there; a longer way round may still do
+			_seen[j] = _stamp;
+			_dist[j] = d;
+			_via[j] = static_cast<uint8_t>(k);
+			if ((goal == Goal::Bait && j == bait) || (goal == Goal::Tail && f > 0)) return d;
+			_queue[tail++] = j;
+			reached++;
+		}
+	}
+	return goal == Goal::None ? reached : -1;
+}
+
+bool Autopilot::safeAfter(uint32_t bait, int dist) {
+	const size_t n = static_cast<size_t>(dist);
+	uint32_t j = bait;
+	for (size_t t = n; t-- > 0;) {
+		_pathCells[t] = j;
+		_plan[t] = _via[j];
+		j = static_cast<uint32_t>(static_cast<int>(j) - _step[_via[j]]);
+	}
+
+	// the body `dist` ticks from now: the path, entered one cell per tick, then as much of
+	// the old body as the growth left to unfold lets it pull along, plus the segment just eaten
+	const int64_t tick = _tick, nSegments = _nSegments, length = _length;
+	for (size_t t = 0; t < n; t++) {
+		_pathSaved[t] = _enteredAt[_pathCells[t]];
+		_enteredAt[_pathCells[t]] = tick + static_cast<int64_t>(t) + 1;
+	}
+	_tick = tick + dist;
+	_nSegments = std::min(length, nSegments + dist);
+	_length = length + 1;
+
+	bool safe = search(bait, 0, Goal::Tail, 0) >= 0;
+
+	for (size_t t = 0; t < n; t++) _enteredAt[_pathCells[t]] = _pathSaved[t];
+	_tick = tick;
+	_nSegments = nSegments;
+	_length = length;
+	return safe;
+}
+
+Action Autopilot::decide(const GameSim& sim) {
+	const bool continued = sync(sim);
+	_stats.decisions++;
+	if (sim.isOver()) { _planLen = 0; return Action::None; }
+
+	// the bait has not moved, it moves only when eaten at the plan's end
+	if (continued && _planPos < _planLen && index(_head) == _pathCells[_planPos - 1]) {
+		_stats.toBait++;
+		_stats.fromPlan++;
+		return static_cast<Action>(_plan[_planPos++]);
+	}
+	_planLen = 0;
+
+	const uint32_t bait = index(sim.getBait().getPos());
+	int dist = search(index(_head), 0, Goal::Bait, bait);
+	if (dist > 0 && safeAfter(bait, dist)) {
+		_planLen = static_cast<size_t>(dist);
+		_planPos = 1;
+		_stats.toBait++;
+		return static_cast<Action>(_plan[0]);
+	}
+	return survive(sim);
+}
+
+// no safe way to the bait: the move from which the tail is furthest yet reachable,
+// else the move with the most room
+Action Autopilot::survive(const GameSim& sim) {
+	const Snake& s = sim.getSnake();
+	const uint32_t head = index(_head);
+	uint32_t moves[4];
+	int dirs[4];
+	int n = 0;
+	for (int k = 0; k < 4; k++) {
+		if (s.isOppositeDirection(static_cast<Direction>(k))) continue;
+		const uint32_t j = static_cast<uint32_t>(static_cast<int>(head) + _step[k]);
+		if (freeIn(j) > 1) continue;
+		moves[n] = j;
+		dirs[n++] = k;
+	}
+	if (n == 0) return Action::None; // boxed in
+
+	int best = -1;
+	int bestScore = -1;
+	for (int m = 0; m < n; m++) {
+		int d = search(moves[m], 1, Goal::Tail, 0);
+		if (d > bestScore) { bestScore = d; best = m; }
+	}
+	if (bestScore >= 0) {
+		_stats.chaseTail++;
+		return static_cast<Action>(dirs[best]);
+	}
+
+	best = 0;
+	for (int m = 0; m < n; m++) {
+		int area = search(moves[m], 1, Goal::None, 0);
+		if (area > bestScore) { bestScore = area; best = m; }
+	}
+	_stats.openArea++;
+	return static_cast<Action>(dirs[best]);
+}
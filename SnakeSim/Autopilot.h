@@ -0,0 +1,81 @@
+#pragma once
+
+// Built-in driver for GameSim, a Policy like the ones ParallelRunner takes: each tick it
+// looks for the shortest path from the head to the bait and plays it through ahead of time;
+// if, having eaten, the snake could still catch up with its own tail, the path is taken and
+// followed to the bait without searching again. Otherwise it chases its tail the long way
+// round, and failing that heads for the largest open area.
+//
+// Searches are breadth-first and time aware: a body cell counts as free from the tick the
+// tail leaves it, so paths may run right behind the tail. The body's entry ticks are kept
+// up to date one cell per tick, and every buffer is sized once per board: no allocation
+// per decision.
+
+#include "GameSim.h"
+#include <cstdint>
+#include <vector>
+
+class Autopilot {
+public:
+	struct Stats {
+		uint64_t decisions = 0;
+		uint64_t toBait = 0;		// on a path to the bait found safe
+		uint64_t fromPlan = 0;		// of those, steps taken without a search
+		uint64_t chaseTail = 0;		// no safe path to the bait, followed the tail
+		uint64_t openArea = 0;		// tail out of reach, went for the most room
+	};
+
+	Action decide(const GameSim& sim);
+	Action operator()(const GameSim& sim) { return decide(sim); }
+
+	const Stats& stats() const { return _stats; }
+
+private:
+	// cells live on a grid padded with a ring of wall cells, so searches need no bounds checks
+	static constexpr int64_t kWall = INT64_MAX / 4;		// entered "in the future": never free
+	static constexpr int64_t kLongFree = INT64_MIN / 4;	// entered and left long ago
+
+	int _width = 0;
+	int _height = 0;
+	int _stride = 0;
+	int _step[4] = {};					// index offset of one step N, E, S, W
+	const GameSim* _sim = nullptr;		// the game the entry ticks below belong to
+	int64_t _tick = 0;
+	int64_t _nSegments = 0;
+	int64_t _length = 0;				// segments plus growth still to unfold
+	Cell _head{ -1, -1 };
+	std::vector<int64_t> _enteredAt;	// per cell: tick the head last entered it, kWall on the rim
+	std::vector<uint32_t> _seen;		// per cell: search stamp
+	std::vector<int> _dist;				// per cell: ticks from now, valid where _seen == _stamp
+	std::vector<uint8_t> _via;			// per cell: step it was reached by
+	std::vector<uint32_t> _queue;
+	std::vector<uint32_t> _pathCells;	// path to the bait, for the look ahead
+	std::vector<int64_t> _pathSaved;	// their _enteredAt while the look ahead overwrites them
+	std::vector<uint8_t> _plan;			// steps of a path found safe, followed without searching again
+	size_t _planPos = 0;
+	size_t _planLen = 0;
+	uint32_t _stamp = 0;
+	Stats _stats;
+
+	uint32_t index(const Cell& c) const { return static_cast<uint32_t>((c.y + 1) * _stride + c.x + 1); }
+
+	// ticks from now until the tail has left cell i, 0 for free cells. Segment k (0 = head)
+	// entered k ticks ago and leaves once the _length - k segments behind it have moved up;
+	// a cell entered at least _nSegments ticks ago has been left already.
+	int64_t freeIn(uint32_t i) const {
+		int64_t k = _tick - _enteredAt[i];
+		return k >= _nSegments ? 0 : _length - k;
+	}
+	// true when sim is the same game one tick (or zero ticks) on, with the head where the plan left it
+	bool sync(const GameSim& sim);
+
+	enum class Goal { Bait, Tail, None };
+	// Breadth-first from cell `from` (reached `t0` ticks from now) over cells free by the time
+	// they are entered; stops at the goal. Returns its distance (or, for Goal::None, the number
+	// of cells reached), -1 when the goal is out of reach; _via leads back to `from`.
+	int search(uint32_t from, int t0, Goal goal, uint32_t bait);
+	// Plays the path of length `dist` to the bait found by the last search: true when, having
+	// eaten, the snake could still catch up with its tail. The path's steps are left in _plan.
+	bool safeAfter(uint32_t bait, int dist);
+	Action survive(const GameSim& sim);
+};
@@ -0,0 +1,176 @@
+#include "BatchedSnakeEnv.h"
+#include "BitOps.h"
+#include <stdexcept>
+
+namespace {
+	const int kDx[4] = {  0, 1, 0, -1 };
+	const int kDy[4] = { -1, 0, 1,  0 };
+	const uint32_t kInitBodySize = 3;
+}
+
+BatchedSnakeEnv::BatchedSnakeEnv(size_t nGames_, int width_, int height_, uint64_t seed_)
+	: _n(nGames_), _width(width_), _height(height_), _seed(seed_)
+{
+	if (nGames_ == 0) { throw std::invalid_argument("nGames must be > 0"); }
+	// sides first so the product cannot overflow; coordinates are int16 in the observations
+	if (width_ <= 0 || height_ <= 0 || width_ > 32767 || height_ > 32767) { throw std::invalid_argument("board sides must be 1..32767"); }
+	if (static_cast<int64_t>(width_) * height_ > 65536) { throw std::invalid_argument("board must have 1..65536 cells"); }
+
+	_nCells = static_cast<uint32_t>(width_ * height_);
+	uint32_t cap = 1;
+	while (cap < _nCells + 1) cap <<= 1;
+	_ringMask = cap - 1;
+	_wordsPerGame = (_nCells + 63) / 64;
+
+	_headX.resize(_n);
+	_headY.resize(_n);
+	_dir.resize(_n);
+	_length.resize(_n);
+	_pending.resize(_n);
+	_score.resize(_n);
+	_ticks.resize(_n);
+	_bait.resize(_n);
+	_headSlot.resize(_n);
+	_rng.resize(_n);
+	_body.resize(_n * cap);
+	_occupied.resize(_n * _wordsPerGame);
+
+	_obs.resize(_n * kObsSize);
+	_reward.resize(_n);
+	_done.resize(_n);
+	_lastScore.resize(_n);
+	_lastTicks.resize(_n);
+
+	reset();
+}
+
+void BatchedSnakeEnv::reset() {
+	_episodes = 0;
+	Rng streams(_seed);
+	for (size_t i = 0; i < _n; i++) {
+		_rng[i] = streams.split();
+		_lastScore[i] = 0;
+		_lastTicks[i] = 0;
+		_reward[i] = 0.0f;
+		_done[i] = 0;
+		resetGame(i);
+		writeObservation(i);
+	}
+}
+
+void BatchedSnakeEnv::resetGame(size_t i) {
+	uint64_t* occ = occupied(i);
+	for (size_t w = 0; w < _wordsPerGame; w++) occ[w] = 0;
+	if (_nCells % 64) occ[_wordsPerGame - 1] = ~uint64_t(0) << (_nCells % 64); // bits past the board count as occupied
+
+	int16_t x = static_cast<int16_t>(_width / 2);
+	int16_t y = static_cast<int16_t>(_height / 2);
+	uint32_t c = static_cast<uint32_t>(y * _width + x);
+	_headX[i] = x;
+	_headY[i] = y;
+	_dir[i] = static_cast<uint8_t>(Direction::N);
+	_length[i] = 1;
+	_pending[i] = kInitBodySize - 1;
+	_score[i] = 0;
+	_ticks[i] = 0;
+	_headSlot[i] = 0;
+	body(i)[0] = static_cast<uint16_t>(c);
+	occ[c >> 6] |= uint64_t(1) << (c & 63);
+	placeBait(i);
+}
+
+// uniform over the free cells: pick k, then find the k-th zero bit
+void BatchedSnakeEnv::placeBait(size_t i) {
+	uint32_t nFree = _nCells - _length[i];
+	if (nFree == 0) return;
+	uint32_t k = _rng[i].below(nFree);
+
+	const uint64_t* occ = occupied(i);
+	for (size_t w = 0; w < _wordsPerGame; w++) {
+		uint64_t freeBits = ~occ[w];
+		uint32_t n = static_cast<uint32_t>(popcount64(freeBits));
+		if (k < n) {
+			_bait[i] = static_cast<uint16_t>(w * 64 + static_cast<size_t>(selectBit64(freeBits, static_cast<int>(k))));
+			return;
+		}
+		k -= n;
+	}
+}
+
+void BatchedSnakeEnv::writeObservation(size_t i) {
+	int16_t* o = &_obs[i * kObsSize];
+	o[0] = _headX[i];
+	o[1] = _headY[i];
+	o[2] = static_cast<int16_t>(_bait[i] % _width);
+	o[3] = static_cast<int16_t>(_bait[i] / _width);
+	o[4] = static_cast<int16_t>(_dir[i]);
+	o[5] = static_cast<int16_t>(_length[i] + _pending[i]);
+}
+
+void BatchedSnakeEnv::step(const Action* actions) {
+	for (size_t i = 0; i < _n; i++) {
+		uint8_t d = _dir[i];
+		uint8_t a = static_cast<uint8_t>(actions[i]);
+		if (a < 4 && a != ((d + 2) & 3)) d = a;
+		_dir[i] = d;
+
+		int x = _headX[i] + kDx[d];
+		int y = _headY[i] + kDy[d];
+		uint64_t* occ = occupied(i);
+		uint16_t* ring = body(i);
+		_ticks[i]++;
+
+		// tail leaves first
+		if (_pending[i] > 0) {
+			_pending[i]--;
+			_length[i]++;
+		} else {
+			uint32_t t = ring[(_headSlot[i] - (_length[i] - 1)) & _ringMask];
+			occ[t >> 6] &= ~(uint64_t(1) << (t & 63));
+		}
+
+		float reward = 0.0f;
+		bool done = false;
+		uint32_t c = static_cast<uint32_t>(y * _width + x);
+		if (static_cast<unsigned>(x) >= static_cast<unsigned>(_width) || static_cast<unsigned>(y) >= static_cast<unsigned>(_height)
+			|| (occ[c >> 6] >> (c & 63)) & 1) {
+			reward = kRewardDeath;
+			done = true;
+		} else {
+			occ[c >> 6] |= uint64_t(1) << (c & 63);
+			uint32_t slot = (_headSlot[i] + 1) & _ringMask;
+			_headSlot[i] = slot;
+			ring[slot] = static_cast<uint16_t>(c);
+			_headX[i] = static_cast<int16_t>(x);
+			_headY[i] = static_cast<int16_t>(y);
+
+			if (c == _bait[i]) {
+				reward = kRewardBait;
+				_score[i]++;
+				_pending[i]++;
+				if (_length[i] == _nCells) done = true; // board filled
+				else placeBait(i);
+			}
+			if (_maxEpisodeTicks && _ticks[i] >= _maxEpisodeTicks) done = true;
+		}
+
+		_reward[i] = reward;
+		_done[i] = done ? 1 : 0;
+		if (done) {
+			_lastScore[i] = _score[i];
+			_lastTicks[i] = _ticks[i];
+			_episodes++;
+			resetGame(i);
+		}
+		writeObservation(i);
+	}
+}
+
+void BatchedSnakeEnv::fillGridObservation(size_t game, uint8_t* out) const {
+	const uint64_t* occ = occupied(game);
+	for (uint32_t c = 0; c < _nCells; c++) {
+		out[c] = static_cast<uint8_t>((occ[c >> 6] >> (c & 63)) & 1);
+	}
+	out[_headY[game] * _width + _headX[game]] = 2;
+	out[_bait[game]] = 3;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+// N independent games stepped together, stored as structure-of-arrays for training loops.
+// Same rules as GameSim (start in the middle heading N with 1 segment + 2 pending,
+// opposite turns ignored, tail leaves before the head enters), boards up to 65536 cells.
+// Finished games are reset in the same step() (like Game::restart), their done flag is set
+// and their observation already describes the new episode.
+
+#include "SimTypes.h"
+#include "Rng.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+class BatchedSnakeEnv {
+public:
+	// per game observation: head x, head y, bait x, bait y, direction, length
+	static constexpr int kObsSize = 6;
+
+	static constexpr float kRewardBait  =  1.0f;
+	static constexpr float kRewardDeath = -1.0f;
+
+	BatchedSnakeEnv(size_t nGames_, int width_ = 20, int height_ = 20, uint64_t seed_ = 0);
+
+	void reset();
+
+	// actions: nGames() entries; fills observations(), rewards() and dones()
+	void step(const Action* actions);
+
+	// 0 = no limit; a game reaching this many ticks is reset as done (truncated)
+	void setMaxEpisodeTicks(uint32_t n) { _maxEpisodeTicks = n; }
+
+	// width * height bytes, row major: 0 empty, 1 body, 2 head, 3 bait
+	void fillGridObservation(size_t game, uint8_t* out) const;
+
+	const int16_t*	observations()	const { return _obs.data(); }
+	const float*	rewards()		const { return _reward.data(); }
+	const uint8_t*	dones()			const { return _done.data(); }
+
+	// score / length of the episode that ended last in that slot
+	const uint32_t* lastEpisodeScores()	const { return _lastScore.data(); }
+	const uint32_t* lastEpisodeTicks()	const { return _lastTicks.data(); }
+
+	size_t	nGames()		const { return _n; }
+	int		width()			const { return _width; }
+	int		height()		const { return _height; }
+	uint64_t totalEpisodes() const { return _episodes; }
+
+private:
+	size_t _n = 0;
+	int _width = 20;
+	int _height = 20;
+	uint32_t _nCells = 0;
+	uint32_t _ringMask = 0;		// body ring capacity - 1 (power of two)
+	size_t _wordsPerGame = 0;	// occupancy words
+	uint64_t _seed = 0;
+	uint32_t _maxEpisodeTicks = 0;
+	uint64_t _episodes = 0;
+
+	// game state
+	std::vector<int16_t>	_headX;
+	std::vector<int16_t>	_headY;
+	std::vector<uint8_t>	_dir;
+	std::vector<uint32_t>	_length;	// segments on the board
+	std::vector<uint32_t>	_pending;	// segments still to unfold
+	std::vector<uint32_t>	_score;
+	std::vector<uint32_t>	_ticks;
+	std::vector<uint16_t>	_bait;		// cell index
+	std::vector<uint32_t>	_headSlot;	// ring slot of the head, the tail is _length - 1 slots behind
+	std::vector<Rng>		_rng;		// game i draws from stream i (i jumps from the seed)
+	std::vector<uint16_t>	_body;		// n * ring capacity cell indices
+	std::vector<uint64_t>	_occupied;	// n * _wordsPerGame bits
+
+	// outputs
+	std::vector<int16_t>	_obs;
+	std::vector<float>		_reward;
+	std::vector<uint8_t>	_done;
+	std::vector<uint32_t>	_lastScore;
+	std::vector<uint32_t>	_lastTicks;
+
+	void resetGame(size_t i);
+	void placeBait(size_t i);
+	void writeObservation(size_t i);
+
+	uint64_t* occupied(size_t i) { return &_occupied[i * _wordsPerGame]; }
+	const uint64_t* occupied(size_t i) const { return &_occupied[i * _wordsPerGame]; }
+	uint16_t* body(size_t i) { return &_body[i * (static_cast<size_t>(_ringMask) + 1)]; }
+	const uint16_t* body(size_t i) const { return &_body[i * (static_cast<size_t>(_ringMask) + 1)]; }
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+// Portable popcount / count-trailing-zeros for 64 bit words.
+
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+inline int popcount64(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcountll(v);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	return static_cast<int>(__popcnt64(v));
+#else
+	v = v - ((v >> 1) & 0x5555555555555555ULL);
+	v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+	v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return static_cast<int>((v * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// v must not be 0
+inline int countTrailingZeros64(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(v);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long i;
+	_BitScanForward64(&i, v);
+	return static_cast<int>(i);
+#else
+	int n = 0;
+	while ((v & 1) == 0) { v >>= 1; n++; }
+	return n;
+#endif
+}
+
+// index of the k-th (0 based) set bit of v, k < popcount64(v)
+inline int selectBit64(uint64_t v, int k) {
+	for (int i = 0; i < k; i++) v &= v - 1;
+	return countTrailingZeros64(v);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+// Built-in 5x7 ASCII font for headless text; glyphs are scaled up by whole pixels.
+
+#include <cstdint>
+
+class BitmapFont {
+public:
+	static constexpr int kGlyphWidth = 5;
+	static constexpr int kGlyphHeight = 7;
+	static constexpr int kAdvance = 6; // glyph + 1 column spacing
+
+	// 7 rows, bit 4 is the leftmost column; unknown characters map to '?'
+	static const uint8_t* glyph(char c);
+
+	// pixel scale for a TextStyle::size, 0 picks the default (14 px cells, like the GDI UI font)
+	static int scaleFor(int size) {
+		if (size <= 0) return 2;
+		int s = size / kGlyphHeight;
+		return s < 1 ? 1 : s;
+	}
+
+	static int textWidth(const char* s, int scale);
+	static int textHeight(int scale) { return kGlyphHeight * scale; }
+};
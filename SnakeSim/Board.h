@@ -0,0 +1,53 @@
+#pragma once
+
+// Board cell bookkeeping shared by the snake and the bait: occupancy bits for collisions
+// and the free-cell set for bait placement, always updated together.
+
+#include "SimTypes.h"
+#include "OccupancyGrid.h"
+#include "FreeCellSet.h"
+
+class Board {
+	int _width = 0;
+	int _height = 0;
+	OccupancyGrid _grid;
+	FreeCellSet _free;
+
+public:
+	Board() = default;
+	Board(int width_, int height_) { reset(width_, height_); }
+
+	void reset(int width_, int height_) {
+		_width = width_;
+		_height = height_;
+		_grid.reset(width_, height_);
+		_free.reset(static_cast<size_t>(width_) * static_cast<size_t>(height_));
+	}
+
+	bool isInside(const Cell& c) const { return c.x >= 0 && c.y >= 0 && c.x < _width && c.y < _height; }
+
+	uint32_t cellIndex(const Cell& c) const { return static_cast<uint32_t>(c.y) * static_cast<uint32_t>(_width) + static_cast<uint32_t>(c.x); }
+	Cell cellAt(uint32_t i) const { return Cell{ static_cast<int>(i % static_cast<uint32_t>(_width)), static_cast<int>(i / static_cast<uint32_t>(_width)) }; }
+
+	// Marks c as covered by a segment; c may be one cell off the board.
+	// Returns true when c was a wall or already covered, i.e. a collision.
+	bool occupy(const Cell& c) {
+		if (_grid.testAndSet(c)) return true;
+		_free.remove(cellIndex(c));
+		return false;
+	}
+
+	void vacate(const Cell& c) {
+		_grid.clear(c);
+		_free.add(cellIndex(c));
+	}
+
+	bool isFree(const Cell& c) const { return isInside(c) && !_grid.test(c); }
+
+	size_t nFree() const { return _free.count(); }
+	Cell freeCell(size_t i) const { return cellAt(_free.at(i)); }
+
+	const OccupancyGrid& grid() const { return _grid; }
+	int width()  const { return _width; }
+	int height() const { return _height; }
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+// One colour class per board cell, rebuilt from the game each frame so the renderer can
+// rasterize the whole board in a single pass instead of one square per object.
+
+#include "GameSim.h"
+#include "RenderTypes.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+enum class CellClass : uint8_t { Empty, Body, Head, Bait, Count };
+
+// fill colour per class plus the shared outline; Empty cells are left untouched
+struct CellPalette {
+	Color fill[static_cast<int>(CellClass::Count)];
+	Color outline;
+};
+
+class CellLayer {
+	int _width = 0;
+	int _height = 0;
+	std::vector<uint8_t> _cells;
+
+public:
+	void reset(int width_, int height_) {
+		_width = width_;
+		_height = height_;
+		_cells.assign(static_cast<size_t>(width_) * static_cast<size_t>(height_), 0);
+	}
+
+	// body, then the head and the bait on top, the same order the scene draws them in
+	void build(const GameSim& sim) {
+		if (sim.width() != _width || sim.height() != _height) reset(sim.width(), sim.height());
+		else std::memset(_cells.data(), 0, _cells.size());
+
+		const Snake& snake = sim.getSnake();
+		for (size_t i = 1; i < snake.nSegments(); i++) set(snake.getSegment(i), CellClass::Body);
+		set(snake.getHead(), CellClass::Head);
+		set(sim.getBait().getPos(), CellClass::Bait);
+	}
+
+	// cells outside the layer are ignored (a head that has just left the board)
+	void set(const Cell& c, CellClass k) {
+		if (c.x < 0 || c.y < 0 || c.x >= _width || c.y >= _height) return;
+		_cells[static_cast<size_t>(c.y) * static_cast<size_t>(_width) + static_cast<size_t>(c.x)] = static_cast<uint8_t>(k);
+	}
+
+	CellClass at(int x, int y) const { return static_cast<CellClass>(row(y)[x]); }
+	const uint8_t* row(int y) const { return _cells.data() + static_cast<size_t>(y) * static_cast<size_t>(_width); }
+
+	int width()  const { return _width; }
+	int height() const { return _height; }
+};
@@ -0,0 +1,140 @@
+#include "CompactSim.h"
+#include "BitOps.h"
+#include "GameSim.h"
+#include <stdexcept>
+
+namespace {
+	const int kDx[4] = {  0, 1, 0, -1 };
+	const int kDy[4] = { -1, 0, 1,  0 };
+	const uint32_t kInitBodySize = 3;
+
+	uint8_t moveBetween(const Cell& from, const Cell& to) {
+		return static_cast<uint8_t>(to.x > from.x ? Direction::E : to.x < from.x ? Direction::W : to.y > from.y ? Direction::S : Direction::N);
+	}
+}
+
+void CompactSim::reset(int width_, int height_, uint64_t seed_) {
+	if (width_ <= 0 || height_ <= 0 || width_ * height_ > kMaxCells) { throw std::invalid_argument("board must have 1..1024 cells"); }
+	*this = CompactSim(); // value-initialised: all zero
+	_width = static_cast<int16_t>(width_);
+	_height = static_cast<int16_t>(height_);
+	_rng.seed(seed_);
+
+	const uint32_t nCells = static_cast<uint32_t>(width_ * height_);
+	for (uint32_t w = nCells / 64; w < kWords; w++) _occupied[w] = ~uint64_t(0);
+	if (nCells % 64) _occupied[nCells / 64] = ~uint64_t(0) << (nCells % 64);
+
+	_headX = static_cast<int16_t>(width_ / 2);
+	_headY = static_cast<int16_t>(height_ / 2);
+	_tail = static_cast<uint16_t>(_headY * width_ + _headX);
+	_occupied[_tail >> 6] |= uint64_t(1) << (_tail & 63);
+	_nSegments = 1;
+	_pending = kInitBodySize - 1;
+	_dir = static_cast<uint8_t>(Direction::N);
+	placeBait();
+}
+
+void CompactSim::assign(const GameSim& sim) {
+	const Snake& s = sim.getSnake();
+	reset(sim.width(), sim.height(), 0);
+	_rng = sim.getRng();
+	_occupied[_tail >> 6] &= ~(uint64_t(1) << (_tail & 63));
+
+	const size_t n = s.nSegments();
+	for (size_t i = 0; i < n; i++) {
+		Cell c = s.getSegment(i);
+		if (!sim.isInside(c)) continue; // the head of a game that ran off the board
+		uint32_t j = static_cast<uint32_t>(c.y * _width + c.x);
+		_occupied[j >> 6] |= uint64_t(1) << (j & 63);
+	}
+	Cell tail = s.getTail();
+	_tail = static_cast<uint16_t>(tail.y * _width + tail.x);
+	_nSegments = 1;
+	for (size_t i = n - 1; i > 0; i--) { // tail to head
+		pushMove(moveBetween(s.getSegment(i), s.getSegment(i - 1)));
+		_nSegments++;
+	}
+	_headX = static_cast<int16_t>(s.getHead().x);
+	_headY = static_cast<int16_t>(s.getHead().y);
+	_pending = static_cast<uint16_t>(s.getPendingGrowth());
+	_dir = static_cast<uint8_t>(s.getCurrentDirection());
+	Cell b = sim.getBait().getPos();
+	_bait = static_cast<uint16_t>(b.y * _width + b.x);
+	_score = static_cast<uint32_t>(sim.score());
+	_ticks = static_cast<uint32_t>(sim.ticks());
+	_isGameOver = sim.isOver();
+	_isWon = sim.isWon();
+}
+
+void CompactSim::setBait(const Cell& c) {
+	if (!isFree(c.x, c.y)) { throw std::invalid_argument("bait must go on a free cell"); }
+	_bait = static_cast<uint16_t>(c.y * _width + c.x);
+}
+
+// uniform over the free cells: pick k, then find the k-th zero bit
+bool CompactSim::placeBait() {
+	const uint32_t nFree = static_cast<uint32_t>(_width * _height) - _nSegments;
+	if (nFree == 0) return false;
+	uint32_t k = _rng.below(nFree);
+	for (uint32_t w = 0; w < kWords; w++) {
+		uint64_t freeBits = ~_occupied[w];
+		uint32_t n = static_cast<uint32_t>(popcount64(freeBits));
+		if (k < n) {
+			_bait = static_cast<uint16_t>(w * 64 + static_cast<uint32_t>(selectBit64(freeBits, static_cast<int>(k))));
+			return true;
+		}
+		k -= n;
+	}
+	return false;
+}
+
+StepResult CompactSim::step(Action action) {
+	StepResult r;
+	if (_isGameOver) {
+		r.gameOver = true;
+		r.won = _isWon != 0;
+		return r;
+	}
+
+	uint8_t a = static_cast<uint8_t>(action);
+	if (a < 4 && a != ((_dir + 2) & 3)) _dir = a;
+	const int x = _headX + kDx[_dir];
+	const int y = _headY + kDy[_dir];
+	_ticks++;
+
+	// the move joins the ring; the tail leaves first, along the oldest move
+	pushMove(_dir);
+	if (_pending > 0) {
+		_pending--;
+		_nSegments++;
+	} else {
+		_occupied[_tail >> 6] &= ~(uint64_t(1) << (_tail & 63));
+		uint8_t t = tailMove();
+		_tail = static_cast<uint16_t>(_tail + kDx[t] + kDy[t] * _width);
+		_tailMove = static_cast<uint16_t>((_tailMove + 1) & (kMaxCells - 1));
+	}
+
+	const uint32_t c = static_cast<uint32_t>(y * _width + x);
+	if (static_cast<unsigned>(x) >= static_cast<unsigned>(_width) || static_cast<unsigned>(y) >= static_cast<unsigned>(_height)
+		|| (_occupied[c >> 6] >> (c & 63)) & 1) {
+		_isGameOver = 1;
+		r.gameOver = true;
+		return r;
+	}
+	_occupied[c >> 6] |= uint64_t(1) << (c & 63);
+	_headX = static_cast<int16_t>(x);
+	_headY = static_cast<int16_t>(y);
+
+	if (c == _bait) {
+		_pending++;
+		_score++;
+		r.ate = true;
+		if (!placeBait()) {
+			_isGameOver = 1;
+			_isWon = 1;
+			r.gameOver = true;
+			r.won = true;
+		}
+	}
+	return r;
+}
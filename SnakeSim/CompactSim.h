@@ -0,0 +1,87 @@
+#pragma once
+
+// GameSim state in one flat, trivially copyable block for look-ahead search: occupancy bits,
+// the body as a ring of 2 bit moves from the tail to the head, head / tail / bait cells, the
+// Rng, score and flags. About 450 bytes for any board up to kMaxCells, so clone() is one
+// memcpy into a slot the caller preallocated, and nothing in it points to the heap.
+//
+// Same rules as GameSim (start in the middle heading N with 1 segment + 2 pending, opposite
+// turns ignored, tail leaves before the head enters). Bait is uniform over the free cells
+// like GameSim's but drawn in row-major order, so a state taken from a GameSim places
+// different bait from the same Rng.
+
+#include "SimTypes.h"
+#include "Rng.h"
+#include <cstdint>
+#include <type_traits>
+
+class GameSim;
+
+class CompactSim {
+public:
+	static constexpr int kMaxCells = 1024; // 32 x 32
+	static constexpr int kWords = kMaxCells / 64;
+
+	CompactSim() = default; // empty: reset() or assign() before stepping
+	CompactSim(int width_, int height_, uint64_t seed_) { reset(width_, height_, seed_); }
+
+	void reset(int width_, int height_, uint64_t seed_);
+	// takes board, snake, bait, Rng, score and ticks of a running game
+	void assign(const GameSim& sim);
+
+	void clone(CompactSim& slot) const { slot = *this; }
+	// a new stream for the bait still to come, e.g. one per rollout so they do not all see the same future
+	void reseed(uint64_t seed_) { _rng.seed(seed_); }
+
+	StepResult step(Action action = Action::None);
+	// moves the bait to a free cell on the board, e.g. to follow the bait of the game it was assigned from
+	void setBait(const Cell& c);
+
+	bool isFree(int x, int y) const {
+		if (static_cast<unsigned>(x) >= static_cast<unsigned>(_width) || static_cast<unsigned>(y) >= static_cast<unsigned>(_height)) return false;
+		uint32_t c = static_cast<uint32_t>(y * _width + x);
+		return !((_occupied[c >> 6] >> (c & 63)) & 1);
+	}
+
+	int			width()		const { return _width; }
+	int			height()	const { return _height; }
+	int			score()		const { return static_cast<int>(_score); }
+	uint32_t	ticks()		const { return _ticks; }
+	bool		isOver()	const { return _isGameOver != 0; }
+	bool		isWon()		const { return _isWon != 0; }
+	Cell		getHead()	const { return Cell{ _headX, _headY }; }
+	Cell		getTail()	const { return Cell{ static_cast<int>(_tail % _width), static_cast<int>(_tail / _width) }; }
+	Cell		getBait()	const { return Cell{ static_cast<int>(_bait % _width), static_cast<int>(_bait / _width) }; }
+	Direction	direction()	const { return static_cast<Direction>(_dir); }
+	uint32_t	nSegments()	const { return _nSegments; }
+	uint32_t	length()	const { return _nSegments + _pending; }
+	bool		isOppositeDirection(Direction d) const { return static_cast<uint8_t>(oppositeDirection(d)) == _dir; }
+
+private:
+	uint64_t _occupied[kWords];			// bit per cell, row major; bits past the board stay set
+	uint8_t _moves[kMaxCells / 4];		// 2 bit Direction from segment i to i + 1, ring indexed by _tailMove
+	Rng _rng;
+	uint32_t _ticks;
+	uint32_t _score;
+	int16_t _width;
+	int16_t _height;
+	int16_t _headX;
+	int16_t _headY;
+	uint16_t _tail;						// cell index
+	uint16_t _bait;						// cell index
+	uint16_t _tailMove;					// ring slot of the move leaving the tail
+	uint16_t _nSegments;
+	uint16_t _pending;
+	uint8_t _dir;
+	uint8_t _isGameOver;
+	uint8_t _isWon;
+
+	void pushMove(uint8_t d) {
+		uint32_t slot = (_tailMove + _nSegments - 1u) & (kMaxCells - 1);
+		_moves[slot >> 2] = static_cast<uint8_t>((_moves[slot >> 2] & ~(3u << ((slot & 3) * 2))) | (d << ((slot & 3) * 2)));
+	}
+	uint8_t tailMove() const { return static_cast<uint8_t>((_moves[_tailMove >> 2] >> ((_tailMove & 3) * 2)) & 3); }
+	bool placeBait();
+};
+
+static_assert(std::is_trivially_copyable<CompactSim>::value, "CompactSim must stay a flat block");
@@ -0,0 +1,31 @@
+#pragma once
+
+// Cells whose picture changed since the renderer last caught up, so a frame can redraw
+// those instead of the whole board. Fixed capacity, no allocation; once it overflows
+// (or after a reset) it reports "everything", which is also the right answer then.
+
+#include "SimTypes.h"
+
+class DirtyCells {
+public:
+	static constexpr int kCapacity = 32;
+
+private:
+	Cell _cells[kCapacity];
+	int _n = 0;
+	bool _all = true; // nothing has been drawn yet
+
+public:
+	void add(const Cell& c) {
+		if (_all) return;
+		if (_n == kCapacity) { _all = true; return; }
+		_cells[_n++] = c;
+	}
+	void markAll() { _all = true; }
+	void clear() { _n = 0; _all = false; }
+
+	bool all() const { return _all; }
+	bool empty() const { return !_all && _n == 0; }
+	int size() const { return _n; } // meaningless when all()
+	const Cell& operator[](int i) const { return _cells[i]; }
+};
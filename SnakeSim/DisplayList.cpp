@@ -0,0 +1,214 @@
+#include "DisplayList.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+	const int kMinBinSize = 32;		// pixels
+	const size_t kMaxBins = 1 << 16;
+
+	bool overlaps(const RectI& a, const RectI& b) { return !a.intersect(b).isEmpty(); }
+
+	uint64_t textKey(Color text, Color background, int size) {
+		return (static_cast<uint64_t>(text.rgba()) << 32) ^ (static_cast<uint64_t>(background.rgba()) << 8) ^ static_cast<uint64_t>(static_cast<uint32_t>(size));
+	}
+}
+
+void DisplayList::reset() {
+	_commands.clear();
+	_text.clear();
+	_sorted = true;
+	_stats = Stats();
+}
+
+void DisplayList::push(Command& c) {
+	c.order = static_cast<uint32_t>(_commands.size());
+	_commands.push_back(c);
+	_sorted = false;
+}
+
+void DisplayList::clear(Color c) {
+	Command cmd;
+	cmd.kind = Kind::Clear;
+	cmd.color = c;
+	push(cmd);
+}
+
+void DisplayList::fillRect(const RectI& r, Color c) {
+	if (c.isTransparent() || r.isEmpty()) return;
+	Command cmd;
+	cmd.kind = Kind::Fill;
+	cmd.rect = r;
+	cmd.color = c;
+	push(cmd);
+}
+
+void DisplayList::frameRect(const RectI& r, Color c) {
+	if (r.isEmpty()) return;
+	fillRect(RectI{ r.left, r.top, r.right, r.top + 1 }, c);
+	fillRect(RectI{ r.left, r.bottom - 1, r.right, r.bottom }, c);
+	fillRect(RectI{ r.left, r.top + 1, r.left + 1, r.bottom - 1 }, c);
+	fillRect(RectI{ r.right - 1, r.top + 1, r.right, r.bottom - 1 }, c);
+}
+
+void DisplayList::drawText(const RectI& r, const char* s, const TextStyle& style) {
+	Command cmd;
+	cmd.kind = Kind::Text;
+	cmd.rect = r;
+	cmd.color = style.text;
+	cmd.background = style.background;
+	cmd.size = style.size;
+	cmd.align = style.align;
+	cmd.text = static_cast<uint32_t>(_text.size());
+	_text.insert(_text.end(), s, s + std::strlen(s) + 1);
+	push(cmd);
+}
+
+bool DisplayList::sameState(const Command& a, const Command& b) {
+	if (a.kind != b.kind) return false;
+	if (a.kind == Kind::Text) return a.color == b.color && a.background == b.background && a.size == b.size;
+	return a.color == b.color;
+}
+
+// A command goes one layer above every earlier command it overlaps, except that a fill
+// may share the layer of an overlapping fill of the same colour (their order does not
+// matter). Commands of different state within a layer are then disjoint and can be
+// drawn in any order. Overlap candidates come from a coarse grid of bins.
+void DisplayList::assignLayers() {
+	RectI bounds{ 0, 0, 0, 0 };
+	bool first = true;
+	for (const Command& c : _commands) {
+		if (c.kind == Kind::Clear) continue;
+		if (first) { bounds = c.rect; first = false; continue; }
+		bounds = RectI{ std::min(bounds.left, c.rect.left), std::min(bounds.top, c.rect.top), std::max(bounds.right, c.rect.right), std::max(bounds.bottom, c.rect.bottom) };
+	}
+
+	int binSize = kMinBinSize;
+	int nx = 1;
+	int ny = 1;
+	for (;;) {
+		nx = std::max(1, (bounds.width() + binSize - 1) / binSize);
+		ny = std::max(1, (bounds.height() + binSize - 1) / binSize);
+		if (static_cast<size_t>(nx) * static_cast<size_t>(ny) <= kMaxBins) break;
+		binSize *= 2;
+	}
+	size_t nBins = static_cast<size_t>(nx) * static_cast<size_t>(ny);
+	if (_bins.size() < nBins) _bins.resize(nBins);
+	for (size_t i = 0; i < nBins; i++) _bins[i].clear();
+
+	int floor = 0;	// nothing moves above a clear
+	int top = -1;
+	for (uint32_t i = 0; i < _commands.size(); i++) {
+		Command& c = _commands[i];
+		if (c.kind == Kind::Clear) {
+			c.layer = top + 1;
+			top = c.layer;
+			floor = c.layer + 1;
+			continue;
+		}
+
+		RectI cr = c.rect.intersect(bounds);
+		int bx0 = (cr.left - bounds.left) / binSize;
+		int by0 = (cr.top - bounds.top) / binSize;
+		int bx1 = (cr.right - 1 - bounds.left) / binSize;
+		int by1 = (cr.bottom - 1 - bounds.top) / binSize;
+
+		int layer = floor;
+		for (int by = by0; by <= by1; by++) {
+			for (int bx = bx0; bx <= bx1; bx++) {
+				for (uint32_t j : _bins[static_cast<size_t>(by) * nx + bx]) {
+					const Command& o = _commands[j];
+					if (o.layer + 1 <= layer || !overlaps(o.rect, c.rect)) continue;
+					bool shareable = c.kind == Kind::Fill && sameState(o, c);
+					layer = std::max(layer, shareable ? o.layer : o.layer + 1);
+				}
+			}
+		}
+		c.layer = layer;
+		top = std::max(top, layer);
+		for (int by = by0; by <= by1; by++) {
+			for (int bx = bx0; bx <= bx1; bx++) {
+				_bins[static_cast<size_t>(by) * nx + bx].push_back(i);
+			}
+		}
+	}
+	_stats.layers = top + 1;
+}
+
+void DisplayList::sortAndMerge() {
+	_stats = Stats();
+	_stats.commands = _commands.size();
+	if (_commands.empty()) { _sorted = true; return; }
+	assignLayers();
+
+	std::sort(_commands.begin(), _commands.end(), [](const Command& a, const Command& b) {
+		if (a.layer != b.layer) return a.layer < b.layer;
+		if (a.kind != b.kind) return a.kind < b.kind;
+		if (a.kind == Kind::Fill) {
+			if (a.color.rgba() != b.color.rgba()) return a.color.rgba() < b.color.rgba();
+			if (a.rect.top != b.rect.top) return a.rect.top < b.rect.top;
+			if (a.rect.bottom != b.rect.bottom) return a.rect.bottom < b.rect.bottom;
+			return a.rect.left < b.rect.left;
+		}
+		if (a.kind == Kind::Text) {
+			uint64_t ka = textKey(a.color, a.background, a.size);
+			uint64_t kb = textKey(b.color, b.background, b.size);
+			if (ka != kb) return ka < kb;
+		}
+		return a.order < b.order;
+	});
+
+	// same layer, same colour, same rows, touching or overlapping: one span
+	size_t out = 0;
+	for (size_t i = 0; i < _commands.size(); i++) {
+		const Command& c = _commands[i];
+		if (out > 0) {
+			Command& prev = _commands[out - 1];
+			if (c.kind == Kind::Fill && prev.kind == Kind::Fill && prev.layer == c.layer && prev.color == c.color
+				&& prev.rect.top == c.rect.top && prev.rect.bottom == c.rect.bottom && c.rect.left <= prev.rect.right) {
+				prev.rect.right = std::max(prev.rect.right, c.rect.right);
+				continue;
+			}
+		}
+		_commands[out++] = c;
+	}
+	_commands.resize(out);
+
+	// as replay() sends them: a fill run of one colour is one call, every clear and every
+	// text is its own (the backend sets up font and colours per drawText)
+	for (size_t i = 0; i < _commands.size(); i++) {
+		const Command& c = _commands[i];
+		if (c.kind == Kind::Fill) _stats.rects++;
+		if (c.kind != Kind::Fill || i == 0 || !sameState(_commands[i - 1], c)) _stats.batches++;
+	}
+	_sorted = true;
+}
+
+void DisplayList::replay(Renderer& target) {
+	if (!_sorted) sortAndMerge();
+
+	for (size_t i = 0; i < _commands.size(); ) {
+		const Command& c = _commands[i];
+		switch (c.kind) {
+			case Kind::Clear: {
+				target.clear(c.color);
+				i++;
+			} break;
+			case Kind::Fill: {
+				_batch.clear();
+				size_t j = i;
+				for (; j < _commands.size() && sameState(_commands[j], c); j++) _batch.push_back(_commands[j].rect);
+				target.fillRects(_batch.data(), _batch.size(), c.color);
+				i = j;
+			} break;
+			case Kind::Text: {
+				TextStyle ts;
+				ts.text = c.color;
+				ts.background = c.background;
+				ts.size = c.size;
+				ts.align = c.align;
+				target.drawText(c.rect, _text.data() + c.text, ts);
+				i++;
+			} break;
+		}
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+// Retained Renderer: the scene records a frame into it, and replay() draws it onto any
+// backend grouped by fill colour / text style, with touching same-coloured rects merged
+// into spans. Commands only move past commands they do not overlap, so the picture is
+// the same as drawing immediately, but a frame costs a constant number of backend state
+// changes however long the snake is.
+
+#include "Renderer.h"
+#include <cstdint>
+#include <vector>
+
+class DisplayList : public Renderer {
+public:
+	struct Stats {
+		size_t commands = 0;	// as recorded, a frame rect counts as its 4 edges
+		size_t rects = 0;		// fills sent to the backend after merging
+		size_t batches = 0;		// backend state changes: one per fill colour run, clear and text
+		int layers = 0;			// groups of mutually non-overlapping commands
+	};
+
+private:
+	enum class Kind : uint8_t { Clear, Fill, Text };
+
+	struct Command {
+		Kind kind = Kind::Fill;
+		int layer = 0;
+		uint32_t order = 0;		// recording order
+		RectI rect;				// Text: the layout rect, which also clips it
+		Color color;			// fill colour, text colour for Text
+		Color background;		// Text only
+		int size = 0;
+		TextAlign align = TextAlign::Center;
+		uint32_t text = 0;		// offset into _text
+	};
+
+	std::vector<Command> _commands;
+	std::vector<char> _text;
+	std::vector<std::vector<uint32_t>> _bins;	// assignLayers scratch: commands per bin
+	std::vector<RectI> _batch;					// replay scratch
+	bool _sorted = true;
+	Stats _stats;
+
+	void push(Command& c);
+	void assignLayers();
+	void sortAndMerge();
+	static bool sameState(const Command& a, const Command& b);
+
+public:
+	// forgets the recorded frame, keeps the memory for the next one
+	void reset();
+
+	void clear(Color c) override;
+	void fillRect(const RectI& r, Color c) override;
+	void frameRect(const RectI& r, Color c) override;
+	void drawText(const RectI& r, const char* s, const TextStyle& style) override;
+
+	// sorts and merges on first use after recording; the list can be replayed again
+	void replay(Renderer& target);
+
+	const Stats& stats() const { return _stats; }
+	bool empty() const { return _commands.empty(); }
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+// Fixed-timestep clock: wall time goes in, whole simulation ticks come out, so the tick rate
+// no longer depends on when (or how late) the front end gets to run. What is left in the
+// accumulator, as a fraction of a tick, is the alpha for drawing between two ticks.
+//
+//	clock.beginFrame(FixedStep::Clock::now());
+//	while (clock.tick(sim.tickDuration())) sim.step();
+//	draw(clock.alpha(sim.tickDuration()));
+
+#include <chrono>
+#include <cstdint>
+
+class FixedStep {
+public:
+	using Clock = std::chrono::steady_clock;
+	using Duration = Clock::duration;
+
+	static constexpr int kMaxCatchUp = 8; // ticks per frame at most; a longer stall is dropped, not replayed
+	static constexpr Duration kUnthrottledSlice = std::chrono::milliseconds(16); // sim time per frame when unthrottled
+
+private:
+	Clock::time_point _last{};
+	Clock::time_point _frameStart{};
+	Duration _accumulator = Duration::zero();
+	int _frameTicks = 0;
+	uint64_t _ticks = 0;
+	uint64_t _dropped = 0;
+	bool _unthrottled = false;
+
+public:
+	void reset(Clock::time_point now) {
+		_last = now;
+		_frameStart = now;
+		_accumulator = Duration::zero();
+		_frameTicks = 0;
+	}
+
+	// Unthrottled: tick() says yes for a whole kUnthrottledSlice of wall time per frame,
+	// i.e. the simulation runs as fast as it can between frames (benchmarking).
+	void setUnthrottled(bool on) { _unthrottled = on; _accumulator = Duration::zero(); }
+	bool unthrottled() const { return _unthrottled; }
+
+	// adds the wall time since the previous frame
+	void beginFrame(Clock::time_point now) {
+		if (now > _last) _accumulator += now - _last;
+		_last = now;
+		_frameStart = now;
+		_frameTicks = 0;
+	}
+
+	// true while a tick of length `step` is due, consuming it
+	bool tick(Duration step) {
+		if (_unthrottled) {
+			if (_frameTicks > 0 && Clock::now() - _frameStart >= kUnthrottledSlice) return false;
+		}
+		else {
+			if (step <= Duration::zero() || _accumulator < step) return false;
+			if (_frameTicks == kMaxCatchUp) { // way behind (debugger, a modal loop): drop the backlog
+				_dropped += static_cast<uint64_t>(_accumulator / step);
+				_accumulator %= step;
+				return false;
+			}
+			_accumulator -= step;
+		}
+		_frameTicks++;
+		_ticks++;
+		return true;
+	}
+
+	// forget the time accumulated so far (paused, or between game states)
+	void hold() { _accumulator = Duration::zero(); }
+
+	// fraction of the next tick already elapsed, [0, 1]; 0 when unthrottled
+	float alpha(Duration step) const {
+		if (_unthrottled || step <= Duration::zero()) return 0.0f;
+		float a = static_cast<float>(std::chrono::duration<double>(_accumulator) / std::chrono::duration<double>(step));
+		return a < 1.0f ? a : 1.0f;
+	}
+
+	// how long the front end may sleep before the next tick is due
+	Duration untilNextTick(Duration step) const {
+		if (_unthrottled) return Duration::zero();
+		return _accumulator < step ? step - _accumulator : Duration::zero();
+	}
+
+	int frameTicks() const { return _frameTicks; }
+	uint64_t ticks() const { return _ticks; }
+	uint64_t dropped() const { return _dropped; } // ticks skipped by the catch-up limit
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+// View of caller-owned pixel memory; the renderer never allocates or frees it.
+
+#include <cstddef>
+#include <cstdint>
+
+enum class PixelFormat {
+	RGBA8,	// 4 bytes per pixel, r g b a in memory order
+	Gray8	// 1 byte per pixel, luma
+};
+
+struct Framebuffer {
+	uint8_t* pixels = nullptr;
+	int width = 0;
+	int height = 0;
+	size_t stride = 0; // bytes per row
+	PixelFormat format = PixelFormat::RGBA8;
+
+	static int bytesPerPixel(PixelFormat f) { return f == PixelFormat::RGBA8 ? 4 : 1; }
+
+	static Framebuffer wrap(uint8_t* pixels_, int width_, int height_, PixelFormat format_) {
+		Framebuffer fb;
+		fb.pixels = pixels_;
+		fb.width = width_;
+		fb.height = height_;
+		fb.format = format_;
+		fb.stride = static_cast<size_t>(width_) * static_cast<size_t>(bytesPerPixel(format_));
+		return fb;
+	}
+
+	static size_t bytesFor(int width_, int height_, PixelFormat format_) {
+		return static_cast<size_t>(width_) * static_cast<size_t>(height_) * static_cast<size_t>(bytesPerPixel(format_));
+	}
+
+	uint8_t* row(int y) const { return pixels + static_cast<size_t>(y) * stride; }
+};
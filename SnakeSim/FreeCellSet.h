@@ -0,0 +1,59 @@
+#pragma once
+
+// Set of free board cells as a dense array plus a position map (swap-remove).
+// add/remove/contains are O(1) and the first count() slots of the dense array are
+// exactly the free cells, so a uniform random free cell is a single draw.
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+class FreeCellSet {
+	std::vector<uint32_t> _cells;	// [0, _count) free, [_count, n) occupied
+	std::vector<uint32_t> _slot;	// cell index -> position in _cells
+	size_t _count = 0;
+
+	void swapSlots(size_t a, size_t b) {
+		uint32_t ca = _cells[a];
+		uint32_t cb = _cells[b];
+		_cells[a] = cb;
+		_cells[b] = ca;
+		_slot[cb] = static_cast<uint32_t>(a);
+		_slot[ca] = static_cast<uint32_t>(b);
+	}
+
+public:
+	FreeCellSet() = default;
+	explicit FreeCellSet(size_t nCells) { reset(nCells); }
+
+	// all cells free
+	void reset(size_t nCells) {
+		_cells.resize(nCells);
+		_slot.resize(nCells);
+		for (size_t i = 0; i < nCells; i++) {
+			_cells[i] = static_cast<uint32_t>(i);
+			_slot[i] = static_cast<uint32_t>(i);
+		}
+		_count = nCells;
+	}
+
+	bool contains(uint32_t cell) const { return _slot[cell] < _count; }
+
+	void remove(uint32_t cell) {
+		if (!contains(cell)) return;
+		swapSlots(_slot[cell], _count - 1);
+		_count--;
+	}
+
+	void add(uint32_t cell) {
+		if (contains(cell)) return;
+		swapSlots(_slot[cell], _count);
+		_count++;
+	}
+
+	// i in [0, count())
+	uint32_t at(size_t i) const { return _cells[i]; }
+
+	size_t count() const { return _count; }
+	bool empty() const { return _count == 0; }
+};
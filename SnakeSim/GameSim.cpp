@@ -0,0 +1,113 @@
+#include "GameSim.h"
+#include "OccupancyGrid.h"
+#include <cstdlib>
+
+GameSim::GameSim(int width_, int height_, uint64_t seed_)
+	: _width(width_), _height(height_), _snake(width_ / 2, height_ / 2), _seed(seed_)
+{
+	reset(width_, height_, seed_);
+}
+
+void GameSim::reset(uint64_t seed_) {
+	reset(_width, _height, seed_);
+}
+
+void GameSim::reset(int width_, int height_, uint64_t seed_) {
+	if (width_ <= 0 || height_ <= 0) { throw std::invalid_argument("board size must be > 0"); }
+	if (width_ > kMaxBoardSide || height_ > kMaxBoardSide) { throw std::invalid_argument("board side too large"); }
+	_width = width_;
+	_height = height_;
+	_seed = seed_;
+	_rng.seed(seed_);
+	_board.reset(width_, height_);
+	_snake.reset(startCell(), _board);
+	_score = 0;
+	_ticks = 0;
+	_isGameOver = false;
+	_isWon = false;
+	placeBait();
+	_dirty.markAll();
+}
+
+StepResult GameSim::step(Action action) {
+	StepResult r;
+	if (_isGameOver) {
+		r.gameOver = true;
+		r.won = _isWon;
+		return r;
+	}
+
+	if (action != Action::None) {
+		_snake.setDirection(static_cast<Direction>(action));
+	}
+
+	_dirty.add(_snake.getTail());
+	_dirty.add(_snake.getHead());
+	_snake.move(_board);
+	_dirty.add(_snake.getHead());
+	_ticks++;
+	if (isGameOver()) {
+		_isGameOver = true;
+		r.gameOver = true;
+		return r;
+	}
+
+	if (_snake.getHead() == _bait.getPos()) {
+		_snake.grow(1);
+		_score++;
+		r.ate = true;
+		if (!placeBait()) {
+			_isGameOver = true;
+			_isWon = true;
+			r.gameOver = true;
+			r.won = true;
+		}
+	}
+	return r;
+}
+
+bool GameSim::isGameOver() const {
+	return _snake.hasCollided();
+}
+
+bool GameSim::isValidBait(const Cell& c) const {
+	return _board.isFree(c);
+}
+
+bool GameSim::placeBait() {
+	if (_board.nFree() == 0) return false;
+	size_t i = _rng.below(static_cast<uint32_t>(_board.nFree()));
+	_dirty.add(_bait.getPos());
+	_bait.setPos(_board.freeCell(i));
+	_baitHash = zobristKey(ZobristFeature::Bait, _bait.getPos());
+	_dirty.add(_bait.getPos());
+	return true;
+}
+
+void GameSim::setSnakeBody(const std::vector<Cell>& body_, Direction d) {
+	if (body_.empty()) { throw std::invalid_argument("snake body must not be empty"); }
+	if (body_.size() > _snake._body.capacity()) { throw std::invalid_argument("snake body too long"); }
+	// checked on a scratch grid first, so a bad body throws with the game untouched
+	OccupancyGrid seen(_width, _height);
+	for (size_t i = 0; i < body_.size(); i++) {
+		const Cell& c = body_[i];
+		if (!isInside(c) || seen.testAndSet(c)) { throw std::invalid_argument("invalid snake body"); }
+		if (i > 0 && std::abs(c.x - body_[i - 1].x) + std::abs(c.y - body_[i - 1].y) != 1) { throw std::invalid_argument("snake body is not connected"); }
+	}
+
+	_board.reset(_width, _height);
+	_snake.clear_body();
+	for (const Cell& c : body_) {
+		_board.occupy(c);
+		_snake._body.pushBack(packCell(c));
+	}
+	_snake._currentDirection = d;
+	_snake._canSetDirection = true;
+	_snake._hasCollided = false;
+	_snake.updateSpeed();
+	_snake.rehash();
+	_isGameOver = false;
+	_isWon = false;
+	if (!isValidBait(_bait.getPos())) placeBait();
+	_dirty.markAll();
+}
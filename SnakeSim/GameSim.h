@@ -0,0 +1,69 @@
+#pragma once
+
+// Headless snake simulation: board, snake, bait and score, no OS or window dependencies.
+// One call to step() is one game tick (one FixedStep tick in the Win32 front end).
+
+#include "SimTypes.h"
+#include "SimSnake.h"
+#include "Board.h"
+#include "DirtyCells.h"
+#include "Rng.h"
+#include <cstdint>
+#include <vector>
+
+class GameSim {
+	int _width = 20;	// in cells
+	int _height = 20;
+	Snake _snake;
+	Bait _bait;
+	Board _board;
+	int _score = 0;
+	uint64_t _ticks = 0;
+	bool _isGameOver = false;
+	bool _isWon = false;
+	uint64_t _seed = 0;
+	Rng _rng;
+	DirtyCells _dirty;
+	uint64_t _baitHash = 0; // Zobrist key of the bait cell
+
+public:
+	static constexpr int kMaxBoardSide = 32767; // PackedCell stores 16 bit coordinates
+
+	GameSim(int width_ = 20, int height_ = 20, uint64_t seed_ = 0);
+
+	void reset() { reset(_seed); }
+	void reset(uint64_t seed_);
+	void reset(int width_, int height_, uint64_t seed_);
+
+	StepResult step(Action action = Action::None);
+
+	bool isInside(const Cell& c) const { return _board.isInside(c); }
+	bool isGameOver() const;
+	bool isValidBait(const Cell& c) const;
+	bool placeBait(); // false when no free cell is left, i.e. the snake filled the board
+
+	// Replaces the snake with the given segments (head first), e.g. to set up a long snake for benchmarks.
+	// Segments must be on the board, distinct and 4-connected.
+	void setSnakeBody(const std::vector<Cell>& body_, Direction d);
+
+	int				width()		const { return _width; }
+	int				height()	const { return _height; }
+	int				score()		const { return _score; }
+	uint64_t		ticks()		const { return _ticks; }
+	uint64_t		seed()		const { return _seed; }
+	bool			isOver()	const { return _isGameOver; }
+	bool			isWon()		const { return _isWon; }
+	const Snake&	getSnake()	const { return _snake; }
+	Snake&			getSnake()		  { return _snake; }
+	const Bait&		getBait()	const { return _bait; }
+	const OccupancyGrid& getGrid() const { return _board.grid(); }
+	const Board&	getBoard()	const { return _board; }
+	const Rng&		getRng()	const { return _rng; }
+	// Zobrist hash of board, head, direction, pending growth and bait (Zobrist.h), kept up
+	// to date by every change instead of recomputed
+	uint64_t		hash()		const { return _snake.hash() ^ _baitHash; }
+	// cells changed by step() since the last clearDirty(): old tail, old and new head, new bait
+	const DirtyCells& dirty()	const { return _dirty; }
+	void			clearDirty()	  { _dirty.clear(); }
+	Cell			startCell() const { return Cell{ _width / 2, _height / 2 }; }
+};
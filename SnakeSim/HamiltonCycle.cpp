@@ -0,0 +1,86 @@
+#include "HamiltonCycle.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+HamiltonCycle::HamiltonCycle(int width_, int height_) : _width(width_), _height(height_) {
+	if (!exists(width_, height_)) { throw std::invalid_argument("board has no Hamiltonian cycle"); }
+
+	// tour on an a x b board with b even, in (u, v) coordinates; transposed when only a is even
+	const bool transposed = height_ % 2 != 0;
+	const int a = transposed ? height_ : width_;
+	const int b = transposed ? width_ : height_;
+	std::vector<Cell> tour;
+	tour.reserve(static_cast<size_t>(a) * static_cast<size_t>(b));
+	for (int u = 0; u < a; u++) tour.push_back(Cell{ u, 0 });
+	for (int v = 1; v < b; v++) {
+		for (int k = 0; k < a - 1; k++) tour.push_back(Cell{ v % 2 == 1 ? a - 1 - k : 1 + k, v });
+	}
+	for (int v = b - 1; v >= 1; v--) tour.push_back(Cell{ 0, v });
+
+	const size_t n = tour.size();
+	_order.assign(n, 0);
+	_next.assign((n + 3) / 4, 0);
+	for (size_t i = 0; i < n; i++) {
+		Cell c = tour[i];
+		Cell d = tour[(i + 1) % n];
+		if (transposed) { std::swap(c.x, c.y); std::swap(d.x, d.y); }
+		Direction dir = d.x > c.x ? Direction::E : d.x < c.x ? Direction::W : d.y > c.y ? Direction::S : Direction::N;
+		size_t j = static_cast<size_t>(c.y) * static_cast<size_t>(_width) + static_cast<size_t>(c.x);
+		_order[j] = static_cast<uint32_t>(i);
+		_next[j >> 2] = static_cast<uint8_t>(_next[j >> 2] | (static_cast<int>(dir) << ((j & 3) * 2)));
+	}
+}
+
+const HamiltonCycle& HamiltonCycle::forBoard(int width_, int height_) {
+	static std::mutex mutex;
+	static std::map<std::pair<int, int>, std::unique_ptr<HamiltonCycle>> cache;
+	std::lock_guard<std::mutex> lock(mutex);
+	std::unique_ptr<HamiltonCycle>& c = cache[std::make_pair(width_, height_)];
+	if (!c) c.reset(new HamiltonCycle(width_, height_));
+	return *c;
+}
+
+Action CyclePilot::decide(const GameSim& sim) const {
+	if (sim.isOver()) return Action::None;
+	const HamiltonCycle& cycle = *_cycle;
+	const Snake& s = sim.getSnake();
+	const Cell head = s.getHead();
+	const uint32_t n = cycle.size();
+
+	// tour distances from the head; the tail is a whole lap away while the snake is one cell
+	uint32_t toTail = cycle.distance(head, s.getTail());
+	if (toTail == 0) toTail = n;
+	const Cell bait = sim.getBait().getPos();
+	const uint32_t toBait = cycle.distance(head, bait);
+	const size_t pending = s.getPendingGrowth();
+	const bool shortcuts = n >= CyclePilot::kMinShortcutCells && (s.getSize() + 1) * 2 < n;
+	const uint32_t slack = n / CyclePilot::kSlackDiv;
+
+	// furthest step ahead that does not pass the bait, the next tour cell once it is
+	// long enough; a reversal is skipped by the sim, so it is no candidate even for a
+	// snake of one cell
+	int best = -1;
+	uint32_t bestAhead = 0;
+	for (int k = 0; k < 4; k++) {
+		const Direction d = static_cast<Direction>(k);
+		if (s.isOppositeDirection(d)) continue;
+		const Cell v = directionAsVector(d);
+		const Cell c{ head.x + v.x, head.y + v.y };
+		if (!sim.isInside(c)) continue;
+		const uint32_t ahead = cycle.distance(head, c);
+		const size_t grow = pending + (c == bait ? 1 : 0);
+		if (ahead == 0 || (ahead > 1 && ahead + grow + slack >= toTail)) continue;
+
+		bool better;
+		if (best < 0) better = true;
+		else if (!shortcuts) better = ahead < bestAhead;
+		else if (ahead <= toBait) better = bestAhead > toBait || ahead > bestAhead;
+		else better = bestAhead > toBait && ahead < bestAhead;
+		if (better) { best = k; bestAhead = ahead; }
+	}
+	if (best < 0) return static_cast<Action>(cycle.next(head)); // cannot happen on a tour-ordered body
+	return static_cast<Action>(best);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+// Hamiltonian cycle of a width x height board: a closed tour through every cell, so a snake
+// that follows it can never trap itself and fills the board. Exists when the board has an
+// even side and both sides are at least 2: row 0 left to right, the other rows serpentine
+// over columns 1.., back up column 0 (columns and rows swap when only the width is even).
+//
+// Built once per board size and shared through forBoard(). Per cell it keeps the tour
+// position and the next step, four steps to the byte.
+
+#include "GameSim.h"
+#include <cstdint>
+#include <vector>
+
+class HamiltonCycle {
+public:
+	HamiltonCycle(int width_, int height_);
+
+	// the cycle of that board size, built by the first caller; safe from any thread
+	static const HamiltonCycle& forBoard(int width_, int height_);
+	static bool exists(int width_, int height_) { return width_ >= 2 && height_ >= 2 && (width_ % 2 == 0 || height_ % 2 == 0); }
+
+	int width() const { return _width; }
+	int height() const { return _height; }
+	uint32_t size() const { return static_cast<uint32_t>(_order.size()); }
+
+	uint32_t order(const Cell& c) const { return _order[static_cast<size_t>(c.y) * static_cast<size_t>(_width) + static_cast<size_t>(c.x)]; }
+	Direction next(const Cell& c) const {
+		size_t i = static_cast<size_t>(c.y) * static_cast<size_t>(_width) + static_cast<size_t>(c.x);
+		return static_cast<Direction>((_next[i >> 2] >> ((i & 3) * 2)) & 3);
+	}
+	// tour steps from a to b
+	uint32_t distance(const Cell& a, const Cell& b) const {
+		uint32_t oa = order(a), ob = order(b);
+		return ob >= oa ? ob - oa : ob + size() - oa;
+	}
+
+private:
+	int _width;
+	int _height;
+	std::vector<uint32_t> _order;	// per cell: position on the tour
+	std::vector<uint8_t> _next;		// per cell: Direction to the next cell, 2 bits
+};
+
+// Policy that follows the cycle, cutting ahead along it towards the bait while the snake
+// covers less than half the board (on boards of 64 cells and more). The body always lies in tour order between tail and
+// head, so every cell ahead of the head up to the tail is free; a shortcut stays on that
+// stretch, so the tour order is never broken. It also leaves room ahead for the growth still
+// to unfold plus a 1/kSlackDiv of the board: bait eaten right ahead holds the tail back, and
+// the cells a shortcut skipped only come free once the tail has passed them.
+// It relies on the game having been driven by this policy from the start.
+class CyclePilot {
+public:
+	static constexpr uint32_t kSlackDiv = 16;
+	static constexpr uint32_t kMinShortcutCells = 64; // below, too little room to cut safely: tour only
+
+	explicit CyclePilot(const HamiltonCycle& cycle_) : _cycle(&cycle_) { }
+
+	Action decide(const GameSim& sim) const;
+	Action operator()(const GameSim& sim) const { return decide(sim); }
+
+private:
+	const HamiltonCycle* _cycle;
+};
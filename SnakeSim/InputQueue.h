@@ -0,0 +1,80 @@
+#pragma once
+
+// Direction commands from the input thread (WM_KEYDOWN) to the simulation tick, through a
+// single-producer / single-consumer lock-free ring. The tick takes at most one command that
+// actually turns the snake and leaves the rest queued for the following ticks, so quick key
+// sequences (e.g. a U-turn as right, down) are no longer lost to the one-turn-per-tick rule.
+
+#include "SimTypes.h"
+#include "SimSnake.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+struct InputCommand {
+	Direction direction = Direction::N;
+	std::chrono::steady_clock::time_point time{}; // when the key went down
+};
+
+class InputQueue {
+public:
+	static constexpr size_t kCapacity = 16; // power of two; more keys than this within a few ticks is mashing
+
+private:
+	static constexpr size_t kLine = 64; // consumer and producer sides on their own cache lines
+
+	InputCommand _slots[kCapacity];
+	alignas(kLine) std::atomic<size_t> _head{ 0 };	// next slot to read, written by the consumer
+	size_t _cachedTail = 0;							// consumer's last look at _tail
+	alignas(kLine) std::atomic<size_t> _tail{ 0 };	// next slot to write, written by the producer
+	size_t _cachedHead = 0;							// producer's last look at _head
+
+public:
+	InputQueue() = default;
+	InputQueue(const InputQueue&) = delete;
+	InputQueue& operator=(const InputQueue&) = delete;
+
+	// producer; false (command dropped) when full
+	bool push(const InputCommand& c) {
+		size_t tail = _tail.load(std::memory_order_relaxed);
+		if (tail - _cachedHead == kCapacity) {
+			_cachedHead = _head.load(std::memory_order_acquire);
+			if (tail - _cachedHead == kCapacity) return false;
+		}
+		_slots[tail & (kCapacity - 1)] = c;
+		_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool push(Direction d) { return push(InputCommand{ d, std::chrono::steady_clock::now() }); }
+
+	// consumer; oldest command first
+	bool pop(InputCommand& out) {
+		size_t head = _head.load(std::memory_order_relaxed);
+		if (head == _cachedTail) {
+			_cachedTail = _tail.load(std::memory_order_acquire);
+			if (head == _cachedTail) return false;
+		}
+		out = _slots[head & (kCapacity - 1)];
+		_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer, once per tick: the oldest command that turns `snake` (not its current direction,
+	// not a reversal). Commands before it that would not turn are dropped; later ones wait.
+	bool nextTurn(const Snake& snake, InputCommand& out) {
+		InputCommand c;
+		while (pop(c)) {
+			if (c.direction == snake.getCurrentDirection() || snake.isOppositeDirection(c.direction)) continue;
+			out = c;
+			return true;
+		}
+		return false;
+	}
+
+	// consumer; e.g. on restart, so keys from the last game do not steer the next one
+	void clear() { InputCommand c; while (pop(c)) { } }
+
+	bool empty() const { return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire); }
+};
@@ -0,0 +1,107 @@
+#include "LargeBoardSim.h"
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+
+void LargeBoardSim::reset(int width_, int height_, uint64_t seed_) {
+	if (width_ <= 0 || height_ <= 0) { throw std::invalid_argument("board size must be > 0"); }
+	if (width_ > kMaxBoardSide || height_ > kMaxBoardSide) { throw std::invalid_argument("board side too large"); }
+	_width = width_;
+	_height = height_;
+	_seed = seed_;
+	_rng.seed(seed_);
+	_grid.reset(width_, height_);
+	if (_body.capacity() == 0) _body.reset(64);
+	_body.clear();
+	_body.pushFront(startCell());
+	_grid.testAndSet(startCell());
+	_pendingGrowth = kInitialLength - 1;
+	_direction = Direction::N;
+	_score = 0;
+	_ticks = 0;
+	_isGameOver = false;
+	_isWon = false;
+	if (!placeBait()) { _isGameOver = true; _isWon = true; } // a 1 x 1 board
+}
+
+void LargeBoardSim::setSnakeBody(const std::vector<Cell>& body_, Direction d) {
+	if (body_.empty()) { throw std::invalid_argument("snake body must not be empty"); }
+	// checked on a grid of its own, which then becomes the board: a bad body throws with
+	// the game untouched
+	SparseGrid grid(_width, _height);
+	for (size_t i = 0; i < body_.size(); i++) {
+		const Cell& c = body_[i];
+		if (!grid.isInside(c) || grid.testAndSet(c)) { throw std::invalid_argument("invalid snake body"); }
+		if (i > 0 && std::abs(c.x - body_[i - 1].x) + std::abs(c.y - body_[i - 1].y) != 1) { throw std::invalid_argument("snake body is not connected"); }
+	}
+	_body.reserve(body_.size() + 1);
+	_grid = std::move(grid);
+	_body.clear();
+	for (const Cell& c : body_) _body.pushBack(c);
+	_pendingGrowth = 0;
+	_direction = d;
+	_isGameOver = false;
+	_isWon = false;
+	// a body covering the whole board has already won, the bait stays under it
+	if (!isFree(_bait) && !placeBait()) { _isGameOver = true; _isWon = true; }
+}
+
+StepResult LargeBoardSim::step(Action action) {
+	StepResult r;
+	if (_isGameOver) {
+		r.gameOver = true;
+		r.won = _isWon;
+		return r;
+	}
+
+	if (action != Action::None && static_cast<Direction>(action) != oppositeDirection(_direction)) {
+		_direction = static_cast<Direction>(action);
+	}
+
+	// the tail leaves before the head enters, as in Snake::move
+	Cell v = directionAsVector(_direction);
+	Cell next{ getHead().x + v.x, getHead().y + v.y };
+	if (_pendingGrowth > 0) {
+		_pendingGrowth--;
+	} else {
+		_grid.clear(getTail());
+		_body.popBack();
+	}
+	if (_body.full()) _body.reserve(_body.capacity() * 2);
+	_body.pushFront(next);
+	bool hit = _grid.testAndSet(next);
+	_ticks++;
+	if (hit) {
+		_isGameOver = true;
+		r.gameOver = true;
+		return r;
+	}
+
+	if (next == _bait) {
+		_pendingGrowth++;
+		_score++;
+		r.ate = true;
+		if (!placeBait()) {
+			_isGameOver = true;
+			_isWon = true;
+			r.gameOver = true;
+			r.won = true;
+		}
+	}
+	return r;
+}
+
+bool LargeBoardSim::placeBait() {
+	uint64_t area = static_cast<uint64_t>(_width) * static_cast<uint64_t>(_height);
+	if (_grid.count() >= area) return false;
+	for (int i = 0; i < kBaitTries; i++) {
+		Cell c{ static_cast<int>(_rng.below(static_cast<uint32_t>(_width))), static_cast<int>(_rng.below(static_cast<uint32_t>(_height))) };
+		if (!_grid.test(c)) { _bait = c; return true; }
+	}
+	// still uniform over the free cells; past 2^32 of them, which kBaitTries misses all but rule out,
+	// the modulo bias is below 2^-31
+	uint64_t nFree = area - _grid.count();
+	uint64_t k = nFree <= UINT32_MAX ? _rng.below(static_cast<uint32_t>(nFree)) : _rng.next() % nFree;
+	_bait = _grid.nthFree(k);
+	return true;
+}
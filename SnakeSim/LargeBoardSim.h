@@ -0,0 +1,77 @@
+#pragma once
+
+// GameSim for the large-arena variant: boards up to 2^30 cells a side (100k x 100k and well
+// beyond), same rules and the same step() contract. Occupancy is a SparseGrid and the body a
+// ring that doubles when full, so memory follows the snake length instead of the board area.
+// Bait goes on a uniformly random free cell by rejection: expected tries are area / free
+// cells, i.e. one while the snake covers a small part of the board, which on a board this
+// size it always does. After kBaitTries misses the board is nearly full, so small, and the
+// bait goes on the k-th free cell found by scanning the tiles instead.
+//
+// GameSim stays the one to use up to 32767 a side: its dense grid and free-cell set are
+// faster per tick there, and the front ends draw it.
+
+#include "SimTypes.h"
+#include "RingBuffer.h"
+#include "Rng.h"
+#include "SparseGrid.h"
+#include <cstdint>
+#include <vector>
+
+class LargeBoardSim {
+public:
+	static constexpr int kMaxBoardSide = 1 << 30;
+	static constexpr size_t kInitialLength = 3; // like Snake: a head plus two pending segments
+	static constexpr int kBaitTries = 64; // random picks before placeBait scans for a free cell
+
+private:
+	int _width = 0;
+	int _height = 0;
+	SparseGrid _grid;
+	RingBuffer<Cell> _body; // front is the head
+	size_t _pendingGrowth = 0;
+	Direction _direction = Direction::N;
+	Cell _bait{ 0, 0 };
+	int _score = 0;
+	uint64_t _ticks = 0;
+	bool _isGameOver = false;
+	bool _isWon = false;
+	uint64_t _seed = 0;
+	Rng _rng;
+
+public:
+	LargeBoardSim(int width_ = 100000, int height_ = 100000, uint64_t seed_ = 0) { reset(width_, height_, seed_); }
+
+	void reset(uint64_t seed_) { reset(_width, _height, seed_); }
+	void reset(int width_, int height_, uint64_t seed_);
+
+	StepResult step(Action action = Action::None);
+	bool placeBait(); // false when no free cell is left
+
+	// Replaces the snake with the given segments (head first), e.g. to set up a long snake
+	// for benchmarks. Segments must be on the board, distinct and 4-connected.
+	void setSnakeBody(const std::vector<Cell>& body_, Direction d);
+
+	bool isInside(const Cell& c) const { return _grid.isInside(c); }
+	bool isFree(const Cell& c) const { return !_grid.test(c); }
+
+	int				width()		const { return _width; }
+	int				height()	const { return _height; }
+	int				score()		const { return _score; }
+	uint64_t		ticks()		const { return _ticks; }
+	uint64_t		seed()		const { return _seed; }
+	bool			isOver()	const { return _isGameOver; }
+	bool			isWon()		const { return _isWon; }
+	Cell			getHead()	const { return _body.front(); }
+	Cell			getTail()	const { return _body.back(); }
+	Cell			getSegment(size_t i) const { return _body[i]; }
+	size_t			nSegments()	const { return _body.size(); }
+	size_t			length()	const { return _body.size() + _pendingGrowth; }
+	Direction		direction()	const { return _direction; }
+	Cell			getBait()	const { return _bait; }
+	const SparseGrid& getGrid()	const { return _grid; }
+	Cell			startCell() const { return Cell{ _width / 2, _height / 2 }; }
+
+	// grid tiles plus the body ring
+	size_t memoryBytes() const { return _grid.memoryBytes() + _body.capacity() * sizeof(Cell); }
+};
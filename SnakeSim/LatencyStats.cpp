@@ -0,0 +1,113 @@
+#include "LatencyStats.h"
+#include <cstdio>
+
+int LatencyHistogram::bucketOf(uint64_t ns) {
+	if (ns < static_cast<uint64_t>(kSub)) return static_cast<int>(ns);
+	int e = 63;
+	while (!(ns >> e)) e--; // e >= kSubBits
+	int sub = static_cast<int>((ns >> (e - kSubBits)) & (kSub - 1));
+	return (e - kSubBits + 1) * kSub + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpper(int b) {
+	if (b < kSub) return static_cast<uint64_t>(b);
+	int e = b / kSub + kSubBits - 1;
+	uint64_t sub = static_cast<uint64_t>(b % kSub);
+	uint64_t lower = (uint64_t{ 1 } << e) | (sub << (e - kSubBits));
+	return lower + (uint64_t{ 1 } << (e - kSubBits)) - 1;
+}
+
+void LatencyHistogram::reset() {
+	for (std::atomic<uint64_t>& c : _counts) c.store(0, std::memory_order_relaxed);
+	_max.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::addTo(uint64_t* counts, uint64_t& maxNs) const {
+	for (int b = 0; b < kBuckets; b++) counts[b] += _counts[b].load(std::memory_order_relaxed);
+	uint64_t m = _max.load(std::memory_order_relaxed);
+	if (m > maxNs) maxNs = m;
+}
+
+LatencyStats& LatencyStats::global() {
+	static LatencyStats stats;
+	return stats;
+}
+
+namespace {
+	std::atomic<int> gThreads{ 0 };
+}
+
+// a thread keeps its slot index for every LatencyStats object, so a slot has one writer
+// unless more than kMaxThreads threads record
+LatencyStats::Slot& LatencyStats::threadSlot() {
+	thread_local int slot = -1;
+	if (slot < 0) {
+		int i = gThreads.fetch_add(1, std::memory_order_relaxed);
+		slot = i < kMaxThreads ? i : kMaxThreads - 1;
+	}
+	return _slots[slot];
+}
+
+void LatencyStats::record(LatencyStage stage, Clock::duration d) {
+	int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+	threadSlot().stage[static_cast<int>(stage)].record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+}
+
+LatencySummary LatencyStats::summary(LatencyStage stage) const {
+	uint64_t counts[LatencyHistogram::kBuckets] = {};
+	LatencySummary s;
+	for (const Slot& slot : _slots) slot.stage[static_cast<int>(stage)].addTo(counts, s.maxNs);
+	for (uint64_t c : counts) s.count += c;
+	if (s.count == 0) return s;
+
+	uint64_t rank50 = (s.count + 1) / 2;
+	uint64_t rank99 = s.count - s.count / 100; // the sample with 1% at or above it
+	uint64_t seen = 0;
+	for (int b = 0; b < LatencyHistogram::kBuckets; b++) {
+		seen += counts[b];
+		if (s.p50Ns == 0 && seen >= rank50) s.p50Ns = LatencyHistogram::bucketUpper(b);
+		if (seen >= rank99) { s.p99Ns = LatencyHistogram::bucketUpper(b); break; }
+	}
+	if (s.p50Ns > s.maxNs) s.p50Ns = s.maxNs; // the top bucket is wider than what landed in it
+	if (s.p99Ns > s.maxNs) s.p99Ns = s.maxNs;
+	return s;
+}
+
+void LatencyStats::reset() {
+	for (Slot& slot : _slots) {
+		for (LatencyHistogram& h : slot.stage) h.reset();
+	}
+}
+
+const char* LatencyStats::stageName(LatencyStage stage) {
+	switch (stage) {
+		case LatencyStage::InputToTick:		return "input->tick";
+		case LatencyStage::TickToPaint:		return "tick->paint";
+		case LatencyStage::InputToPaint:	return "input->paint";
+		default:							return "?";
+	}
+}
+
+size_t LatencyStats::format(char* buff, size_t size) const {
+	if (!buff || size == 0) return 0;
+	size_t n = 0;
+	buff[0] = '\0';
+	for (int i = 0; i < kStages && n < size; i++) {
+		LatencyStage stage = static_cast<LatencyStage>(i);
+		LatencySummary s = summary(stage);
+		int w = snprintf(buff + n, size - n, "%s n=%llu p50=%.1fms p99=%.1fms max=%.1fms\n", stageName(stage),
+			static_cast<unsigned long long>(s.count), s.p50Ns / 1e6, s.p99Ns / 1e6, s.maxNs / 1e6);
+		if (w < 0) break;
+		n += static_cast<size_t>(w);
+	}
+	return n < size ? n : size - 1;
+}
+
+size_t LatencyStats::formatShort(char* buff, size_t size) const {
+	if (!buff || size == 0) return 0;
+	LatencySummary s = summary(LatencyStage::InputToPaint);
+	if (s.count == 0) { buff[0] = '\0'; return 0; }
+	int w = snprintf(buff, size, "p50 %.1f p99 %.1f ms", s.p50Ns / 1e6, s.p99Ns / 1e6);
+	if (w < 0) { buff[0] = '\0'; return 0; }
+	return static_cast<size_t>(w) < size ? static_cast<size_t>(w) : size - 1;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+// Input-to-photon latency: a key press is timestamped when it is queued (InputCommand::time),
+// again when a tick applies it, and once more when the frame showing it has been painted.
+// Samples go into per-thread log-linear histograms (lock-free, one relaxed add per sample)
+// that are merged only when someone asks for p50 / p99 / max.
+//
+// Build with SNAKE_LATENCY=0 (CMake: -DSNAKESIM_LATENCY=OFF) and every record() call site
+// compiles to nothing; the histogram classes themselves stay available.
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef SNAKE_LATENCY
+#define SNAKE_LATENCY 1
+#endif
+
+enum class LatencyStage : int {
+	InputToTick = 0,	// key down -> the tick that turned the snake
+	TickToPaint,		// that tick -> end of the WM_PAINT showing it
+	InputToPaint,		// key down -> end of that WM_PAINT, the whole way
+	Count
+};
+
+struct LatencySummary {
+	uint64_t count = 0;
+	uint64_t p50Ns = 0;	// bucket upper bounds, within 12.5%
+	uint64_t p99Ns = 0;
+	uint64_t maxNs = 0;	// exact
+};
+
+class LatencyHistogram {
+public:
+	static constexpr int kSubBits = 3; // 8 buckets per power of two
+	static constexpr int kSub = 1 << kSubBits;
+	static constexpr int kBuckets = (64 - kSubBits + 1) * kSub;
+
+	static int bucketOf(uint64_t ns);
+	static uint64_t bucketUpper(int b); // largest value landing in bucket b
+
+	void record(uint64_t ns) {
+		_counts[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+		uint64_t m = _max.load(std::memory_order_relaxed);
+		while (ns > m && !_max.compare_exchange_weak(m, ns, std::memory_order_relaxed)) { }
+	}
+
+	void reset();
+	void addTo(uint64_t* counts, uint64_t& maxNs) const; // counts: kBuckets entries
+
+private:
+	std::atomic<uint64_t> _counts[kBuckets] = {};
+	std::atomic<uint64_t> _max{ 0 };
+};
+
+class LatencyStats {
+public:
+	static constexpr bool kEnabled = SNAKE_LATENCY != 0;
+	static constexpr int kMaxThreads = 8; // threads past this share the last slot (still correct, just contended)
+	static constexpr int kStages = static_cast<int>(LatencyStage::Count);
+
+	using Clock = std::chrono::steady_clock;
+
+	static LatencyStats& global();
+
+	// any thread; one relaxed add into the calling thread's histogram
+	void record(LatencyStage stage, Clock::duration d);
+	void record(LatencyStage stage, Clock::time_point from, Clock::time_point to) { record(stage, to - from); }
+
+	// merged over threads; safe while others record (a sample may land just after the snapshot)
+	LatencySummary summary(LatencyStage stage) const;
+	void reset();
+
+	// one line per stage: "input->paint n=12 p50=9.8ms p99=31.2ms max=33.0ms"
+	size_t format(char* buff, size_t size) const;
+	// UI bar sized: "p50 9.8 p99 31.2 ms" of InputToPaint, empty before the first sample
+	size_t formatShort(char* buff, size_t size) const;
+
+	static const char* stageName(LatencyStage stage);
+
+private:
+	struct Slot {
+		LatencyHistogram stage[kStages];
+	};
+
+	Slot _slots[kMaxThreads];
+
+	Slot& threadSlot();
+};
+
+// the call sites' form: vanishes when SNAKE_LATENCY=0
+inline void recordLatency(LatencyStage stage, LatencyStats::Clock::time_point from, LatencyStats::Clock::time_point to) {
+	if (LatencyStats::kEnabled) LatencyStats::global().record(stage, from, to);
+}
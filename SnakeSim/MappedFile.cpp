@@ -0,0 +1,57 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::open(const std::filesystem::path& path) {
+	close();
+#ifdef _WIN32
+	HANDLE f = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (f == INVALID_HANDLE_VALUE) return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(f, &size) || size.QuadPart == 0) { CloseHandle(f); return false; }
+	HANDLE m = CreateFileMappingW(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!m) { CloseHandle(f); return false; }
+	void* p = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+	if (!p) { CloseHandle(m); CloseHandle(f); return false; }
+	_file = f;
+	_mapping = m;
+	_data = static_cast<const uint8_t*>(p);
+	_size = static_cast<size_t>(size.QuadPart);
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) { ::close(fd); return false; }
+	void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	if (p == MAP_FAILED) { ::close(fd); return false; }
+	_fd = fd;
+	_data = static_cast<const uint8_t*>(p);
+	_size = static_cast<size_t>(st.st_size);
+#endif
+	return true;
+}
+
+void MappedFile::close() {
+	if (!_data) return;
+#ifdef _WIN32
+	UnmapViewOfFile(_data);
+	CloseHandle(static_cast<HANDLE>(_mapping));
+	CloseHandle(static_cast<HANDLE>(_file));
+	_file = nullptr;
+	_mapping = nullptr;
+#else
+	munmap(const_cast<uint8_t*>(_data), _size);
+	::close(_fd);
+	_fd = -1;
+#endif
+	_data = nullptr;
+	_size = 0;
+}
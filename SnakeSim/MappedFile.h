@@ -0,0 +1,34 @@
+#pragma once
+
+// Read-only memory mapping of a whole file; the OS specifics stay in MappedFile.cpp.
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+class MappedFile {
+	const uint8_t* _data = nullptr;
+	size_t _size = 0;
+#ifdef _WIN32
+	void* _file = nullptr;
+	void* _mapping = nullptr;
+#else
+	int _fd = -1;
+#endif
+
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::filesystem::path& path) { open(path); }
+	~MappedFile() { close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// a path, so names outside the ANSI code page open on Windows too
+	bool open(const std::filesystem::path& path);
+	void close();
+
+	bool isOpen() const { return _data != nullptr; }
+	const uint8_t* data() const { return _data; }
+	size_t size() const { return _size; }
+};
@@ -0,0 +1,146 @@
+#include "MctsPlanner.h"
+#include "GameSim.h"
+#include "ParallelRunner.h"
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+MctsPlanner::MctsPlanner(const MctsConfig& config_, ParallelRunner* runner_)
+	: _config(config_), _runner(runner_)
+{
+	if (config_.nTrees == 0 || config_.iterations == 0) { throw std::invalid_argument("MCTS needs at least one tree and one iteration"); }
+	_trees.resize(config_.nTrees);
+	for (Tree& t : _trees) {
+		t.nodes.reserve(static_cast<size_t>(config_.iterations) + 1);
+		t.path.reserve(static_cast<size_t>(config_.iterations) + 1);
+	}
+}
+
+Action MctsPlanner::decide(const GameSim& sim) {
+	_root.assign(sim);
+	return decide(_root);
+}
+
+Action MctsPlanner::decide(const CompactSim& root) {
+	if (root.isOver()) return Action::None;
+	const uint64_t decision = _stats.decisions++;
+	const size_t nTrees = _trees.size();
+
+	auto growTrees = [&](size_t begin, size_t end, unsigned) {
+		for (size_t i = begin; i < end; i++) {
+			uint64_t state = _config.seed + decision * nTrees + i;
+			grow(_trees[i], root, Rng::splitmix64(state));
+		}
+	};
+	if (_runner) _runner->parallelFor(nTrees, 1, growTrees);
+	else growTrees(0, nTrees, 0);
+
+	uint64_t visits[4] = { 0, 0, 0, 0 };
+	for (Tree& t : _trees) {
+		const Node& r = t.nodes[0];
+		for (int k = 0; k < 4; k++) {
+			if (r.child[k]) visits[k] += t.nodes[r.child[k]].visits;
+		}
+		_stats.rollouts += t.rollouts;
+		_stats.ticks += t.ticks;
+		t.rollouts = 0;
+		t.ticks = 0;
+	}
+	int best = -1;
+	for (int k = 0; k < 4; k++) {
+		if (visits[k] > 0 && (best < 0 || visits[k] > visits[best])) best = k;
+	}
+	return best < 0 ? Action::None : static_cast<Action>(best);
+}
+
+void MctsPlanner::grow(Tree& t, const CompactSim& root, uint64_t seed) {
+	Rng rng(seed);
+	t.nodes.clear();
+	t.nodes.push_back(Node{ { 0, 0, 0, 0 }, 0, 0.0f });
+
+	for (uint32_t it = 0; it < _config.iterations; it++) {
+		CompactSim& s = t.slot;
+		root.clone(s);
+		s.reseed(rng.next());
+		t.path.clear();
+		t.path.push_back(0);
+		uint32_t n = 0;
+		float reward = 0.0f;
+		float weight = 1.0f; // discount of the tick about to be played
+		auto play = [&](Action a) {
+			if (s.step(a).ate) reward += weight;
+			weight *= _config.discount;
+			t.ticks++;
+		};
+
+		// down the tree by UCT until a move not tried yet, which becomes the new leaf
+		while (!s.isOver()) {
+			int pick = -1;
+			for (int k = 0; k < 4; k++) {
+				if (!s.isOppositeDirection(static_cast<Direction>(k)) && t.nodes[n].child[k] == 0) { pick = k; break; }
+			}
+			if (pick >= 0) {
+				if (t.nodes.size() == t.nodes.capacity()) break; // pool full: roll out from here
+				uint32_t c = static_cast<uint32_t>(t.nodes.size());
+				t.nodes.push_back(Node{ { 0, 0, 0, 0 }, 0, 0.0f });
+				t.nodes[n].child[pick] = c;
+				play(static_cast<Action>(pick));
+				t.path.push_back(c);
+				break;
+			}
+
+			const float logN = std::log(static_cast<float>(t.nodes[n].visits));
+			float bestScore = -INFINITY;
+			for (int k = 0; k < 4; k++) {
+				if (s.isOppositeDirection(static_cast<Direction>(k))) continue;
+				const Node& c = t.nodes[t.nodes[n].child[k]];
+				float v = static_cast<float>(c.visits);
+				float u = c.value / v + _config.exploration * std::sqrt(logN / v);
+				if (u > bestScore) { bestScore = u; pick = k; }
+			}
+			play(static_cast<Action>(pick));
+			n = t.nodes[n].child[pick];
+			t.path.push_back(n);
+		}
+
+		for (uint32_t r = 0; r < _config.rolloutTicks && !s.isOver(); r++) {
+			play(rolloutMove(s, rng));
+		}
+		if (s.isOver()) {
+			if (!s.isWon()) reward -= weight;
+		} else { // alive: up to half a bait more the closer it ended to the next one
+			const Cell h = s.getHead();
+			const Cell b = s.getBait();
+			reward += weight * (0.5f - 0.5f * static_cast<float>(std::abs(b.x - h.x) + std::abs(b.y - h.y)) / static_cast<float>(s.width() + s.height()));
+		}
+		for (uint32_t i : t.path) {
+			t.nodes[i].visits++;
+			t.nodes[i].value += reward;
+		}
+		t.rollouts++;
+	}
+}
+
+// random among the moves onto free cells, three times in four one that closes in on the bait
+Action MctsPlanner::rolloutMove(const CompactSim& s, Rng& rng) {
+	const Cell h = s.getHead();
+	const Cell b = s.getBait();
+	const int dist = std::abs(b.x - h.x) + std::abs(b.y - h.y);
+	int moves[3];
+	int closer[3];
+	int n = 0;
+	int nCloser = 0;
+	for (int k = 0; k < 4; k++) {
+		const Direction d = static_cast<Direction>(k);
+		if (s.isOppositeDirection(d)) continue;
+		const Cell v = directionAsVector(d);
+		const Cell c{ h.x + v.x, h.y + v.y };
+		if (!s.isFree(c.x, c.y)) continue;
+		moves[n++] = k;
+		if (std::abs(b.x - c.x) + std::abs(b.y - c.y) < dist) closer[nCloser++] = k;
+	}
+	if (n == 0) return Action::None;
+	uint32_t r = rng.next32();
+	if (nCloser > 0 && (r & 3) != 0) return static_cast<Action>(closer[(r >> 2) % static_cast<uint32_t>(nCloser)]);
+	return static_cast<Action>(moves[(r >> 2) % static_cast<uint32_t>(n)]);
+}
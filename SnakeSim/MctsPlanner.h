@@ -0,0 +1,73 @@
+#pragma once
+
+// Monte Carlo tree search over CompactSim, root-parallel: each decision grows nTrees
+// independent UCT trees from the same root, one tree per ParallelRunner task, and plays the
+// root move with the most visits summed over the trees. Tree i is seeded from (seed,
+// decision, i), so the chosen move does not depend on the thread count.
+//
+// Every iteration clones the root into the tree's scratch slot and reseeds its Rng (bait
+// yet to appear is sampled, not known), walks down by UCT, adds one node and rolls out with
+// random moves that avoid walls and body where they can and mostly close in on the bait.
+// Reward is bait eaten, minus one for dying, each discounted by how many ticks ahead it
+// happens; a snake still alive gets up to half a bait for ending close to the next one, so
+// bait beyond the rollout horizon still pulls. Node pools and slots are sized once from the
+// config: no allocation per decision.
+
+#include "CompactSim.h"
+#include <cstdint>
+#include <vector>
+
+class GameSim;
+class ParallelRunner;
+
+struct MctsConfig {
+	unsigned nTrees = 4;
+	uint32_t iterations = 256;		// per tree and decision
+	uint32_t rolloutTicks = 32;		// cut off after this many random moves
+	float exploration = 0.5f;		// UCT c, rewards are around one bait
+	float discount = 0.95f;			// per tick
+	uint64_t seed = 0;
+};
+
+class MctsPlanner {
+public:
+	struct Stats {
+		uint64_t decisions = 0;
+		uint64_t rollouts = 0;
+		uint64_t ticks = 0;			// simulated, tree walks and rollouts
+	};
+
+	// runner = nullptr: all trees on the calling thread
+	explicit MctsPlanner(const MctsConfig& config_ = MctsConfig(), ParallelRunner* runner_ = nullptr);
+
+	Action decide(const CompactSim& root);
+	Action decide(const GameSim& sim);
+	Action operator()(const GameSim& sim) { return decide(sim); }
+
+	const MctsConfig& config() const { return _config; }
+	const Stats& stats() const { return _stats; }
+
+private:
+	struct Node {
+		uint32_t child[4];			// 0: not expanded (node 0 is the root, never a child)
+		uint32_t visits;
+		float value;				// reward summed over visits
+	};
+
+	struct alignas(64) Tree {		// own cache lines: each is written by one thread
+		std::vector<Node> nodes;	// capacity iterations + 1, node 0 the root
+		std::vector<uint32_t> path;
+		CompactSim slot;
+		uint64_t rollouts = 0;
+		uint64_t ticks = 0;
+	};
+
+	MctsConfig _config;
+	ParallelRunner* _runner;
+	std::vector<Tree> _trees;
+	CompactSim _root;
+	Stats _stats;
+
+	void grow(Tree& t, const CompactSim& root, uint64_t seed);
+	static Action rolloutMove(const CompactSim& s, Rng& rng);
+};
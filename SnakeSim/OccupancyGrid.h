@@ -0,0 +1,63 @@
+#pragma once
+
+// One bit per board cell, set while a snake segment covers it.
+// The board is padded with a ring of always-set wall cells, so a head that has just
+// left the board is caught by the same single bit test as a head biting its body.
+
+#include "SimTypes.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+class OccupancyGrid {
+	int _width = 0;
+	int _height = 0;
+	int _stride = 2;
+	std::vector<uint64_t> _bits;
+
+	void setBit(size_t i)			{ _bits[i >> 6] |=  (uint64_t(1) << (i & 63)); }
+	void clearBit(size_t i)			{ _bits[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+	bool testBit(size_t i) const	{ return (_bits[i >> 6] >> (i & 63)) & 1; }
+
+public:
+	OccupancyGrid() = default;
+	OccupancyGrid(int width_, int height_) { reset(width_, height_); }
+
+	void reset(int width_, int height_) {
+		_width = width_;
+		_height = height_;
+		_stride = width_ + 2;
+		size_t n = static_cast<size_t>(_stride) * static_cast<size_t>(height_ + 2);
+		_bits.assign((n + 63) / 64, 0);
+
+		for (int x = -1; x <= _width; x++) {
+			setBit(index(Cell{ x, -1 }));
+			setBit(index(Cell{ x, _height }));
+		}
+		for (int y = 0; y < _height; y++) {
+			setBit(index(Cell{ -1, y }));
+			setBit(index(Cell{ _width, y }));
+		}
+	}
+
+	// c may be at most one cell outside the board.
+	size_t index(const Cell& c) const {
+		assert(c.x >= -1 && c.y >= -1 && c.x <= _width && c.y <= _height);
+		return static_cast<size_t>(c.y + 1) * static_cast<size_t>(_stride) + static_cast<size_t>(c.x + 1);
+	}
+
+	bool test(const Cell& c) const	{ return testBit(index(c)); }
+	void set(const Cell& c)			{ setBit(index(c)); }
+	void clear(const Cell& c)		{ if (c.x >= 0 && c.y >= 0 && c.x < _width && c.y < _height) clearBit(index(c)); }
+
+	// returns the previous state of the bit, i.e. whether c was a wall or a segment
+	bool testAndSet(const Cell& c) {
+		size_t i = index(c);
+		bool was = testBit(i);
+		setBit(i);
+		return was;
+	}
+
+	int width()  const { return _width; }
+	int height() const { return _height; }
+};
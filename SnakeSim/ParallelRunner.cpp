@@ -0,0 +1,133 @@
+#include "ParallelRunner.h"
+
+ParallelRunner::ParallelRunner(unsigned nThreads_) {
+	if (nThreads_ == 0) nThreads_ = std::thread::hardware_concurrency();
+	_nThreads = nThreads_ ? nThreads_ : 1;
+
+	for (unsigned i = 0; i < _nThreads; i++) {
+		_queues.emplace_back(new WorkQueue());
+	}
+	// the calling thread works as thread 0
+	for (unsigned i = 1; i < _nThreads; i++) {
+		_threads.emplace_back(&ParallelRunner::workerLoop, this, i);
+	}
+}
+
+ParallelRunner::~ParallelRunner() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_wake.notify_all();
+	for (auto& t : _threads) t.join();
+}
+
+uint64_t ParallelRunner::episodeSeed(uint64_t baseSeed, size_t i) {
+	// splitmix64 of (base, i): neighbouring episodes get unrelated seeds
+	uint64_t state = baseSeed + static_cast<uint64_t>(i) * 0x9E3779B97F4A7C15ULL;
+	return Rng::splitmix64(state);
+}
+
+bool ParallelRunner::popLocal(unsigned idx, Range& r) {
+	WorkQueue& q = *_queues[idx];
+	std::lock_guard<std::mutex> lock(q.mutex);
+	if (q.ranges.empty()) return false;
+	r = q.ranges.back();
+	q.ranges.pop_back();
+	return true;
+}
+
+bool ParallelRunner::steal(unsigned idx, Range& r) {
+	for (unsigned k = 1; k < _nThreads; k++) {
+		WorkQueue& q = *_queues[(idx + k) % _nThreads];
+		std::lock_guard<std::mutex> lock(q.mutex);
+		if (q.ranges.empty()) continue;
+		r = q.ranges.front(); // oldest chunk, furthest from what the owner works on
+		q.ranges.pop_front();
+		return true;
+	}
+	return false;
+}
+
+// no work is added while a job runs, so once every queue is empty the thread is done
+void ParallelRunner::drain(unsigned idx) {
+	Range r;
+	while (popLocal(idx, r) || steal(idx, r)) {
+		(*_job)(r.begin, r.end, idx);
+	}
+}
+
+void ParallelRunner::workerLoop(unsigned idx) {
+	uint64_t seen = 0;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wake.wait(lock, [&] { return _quit || _generation != seen; });
+			if (_quit) return;
+			seen = _generation;
+		}
+		drain(idx);
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (--_busy == 0) _finished.notify_one();
+		}
+	}
+}
+
+void ParallelRunner::parallelFor(size_t n, size_t grain, const RangeFn& fn) {
+	if (n == 0) return;
+	if (grain == 0) grain = 1;
+
+	// deal contiguous blocks of chunks, thread t starts on its own block
+	size_t nChunks = (n + grain - 1) / grain;
+	for (size_t c = 0; c < nChunks; c++) {
+		unsigned owner = static_cast<unsigned>(c * _nThreads / nChunks);
+		size_t b = c * grain;
+		size_t e = b + grain < n ? b + grain : n;
+		_queues[owner]->ranges.push_back(Range{ b, e });
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_job = &fn;
+		_busy = _nThreads - 1;
+		_generation++;
+	}
+	_wake.notify_all();
+
+	drain(0);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_finished.wait(lock, [&] { return _busy == 0; });
+	_job = nullptr;
+}
+
+std::vector<EpisodeResult> ParallelRunner::runEpisodes(size_t nGames, int width, int height, uint64_t baseSeed,
+	const PolicyFactory& makePolicy, uint64_t maxTicks, size_t grain)
+{
+	std::vector<EpisodeResult> results(nGames);
+	std::vector<Policy> policies(_nThreads);
+	std::vector<std::unique_ptr<GameSim>> sims(_nThreads);
+	for (unsigned t = 0; t < _nThreads; t++) {
+		policies[t] = makePolicy();
+		sims[t].reset(new GameSim(width, height, 0));
+	}
+
+	parallelFor(nGames, grain, [&](size_t begin, size_t end, unsigned t) {
+		GameSim& sim = *sims[t];
+		const Policy& policy = policies[t];
+		for (size_t i = begin; i < end; i++) {
+			uint64_t seed = episodeSeed(baseSeed, i);
+			sim.reset(seed);
+			while (!sim.isOver() && (maxTicks == 0 || sim.ticks() < maxTicks)) {
+				sim.step(policy(sim));
+			}
+			EpisodeResult& r = results[i];
+			r.seed = seed;
+			r.score = sim.score();
+			r.ticks = sim.ticks();
+			r.won = sim.isWon();
+		}
+	});
+	return results;
+}
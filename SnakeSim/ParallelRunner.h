@@ -0,0 +1,74 @@
+#pragma once
+
+// Thread pool that runs many independent GameSim episodes across cores.
+// Work is cut into chunks and dealt to per-thread deques; an idle thread steals chunks from
+// the others, so ragged episode lengths do not leave cores idle. Episode i is always seeded
+// with episodeSeed(baseSeed, i), so results do not depend on the thread count.
+
+#include "GameSim.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct EpisodeResult {
+	uint64_t seed = 0;
+	int score = 0;
+	uint64_t ticks = 0;
+	bool won = false;
+};
+
+typedef std::function<Action(const GameSim&)> Policy;
+typedef std::function<Policy()> PolicyFactory; // called once per thread and run, policies may keep state
+
+class ParallelRunner {
+public:
+	// fn(begin, end, threadIdx) handles indices [begin, end)
+	typedef std::function<void(size_t, size_t, unsigned)> RangeFn;
+
+	explicit ParallelRunner(unsigned nThreads_ = 0); // 0: one per hardware thread
+	~ParallelRunner();
+
+	ParallelRunner(const ParallelRunner&) = delete;
+	ParallelRunner& operator=(const ParallelRunner&) = delete;
+
+	unsigned nThreads() const { return _nThreads; }
+
+	void parallelFor(size_t n, size_t grain, const RangeFn& fn);
+
+	// maxTicks = 0: run every episode until game over
+	std::vector<EpisodeResult> runEpisodes(size_t nGames, int width, int height, uint64_t baseSeed,
+		const PolicyFactory& makePolicy, uint64_t maxTicks = 0, size_t grain = 16);
+
+	static uint64_t episodeSeed(uint64_t baseSeed, size_t i);
+
+private:
+	struct Range { size_t begin; size_t end; };
+
+	struct WorkQueue {
+		std::mutex mutex;
+		std::deque<Range> ranges;
+	};
+
+	unsigned _nThreads = 1;
+	std::vector<std::thread> _threads;
+	std::vector<std::unique_ptr<WorkQueue>> _queues;
+
+	std::mutex _mutex;
+	std::condition_variable _wake;
+	std::condition_variable _finished;
+	uint64_t _generation = 0;
+	unsigned _busy = 0;
+	bool _quit = false;
+	const RangeFn* _job = nullptr;
+
+	void workerLoop(unsigned idx);
+	void drain(unsigned idx);
+	bool popLocal(unsigned idx, Range& r);
+	bool steal(unsigned idx, Range& r);
+};
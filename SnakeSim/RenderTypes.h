@@ -0,0 +1,50 @@
+#pragma once
+
+// Platform independent drawing types: the GDI front end and the software framebuffer
+// both draw from these.
+
+#include <cstdint>
+
+struct Color {
+	uint8_t r = 0;
+	uint8_t g = 0;
+	uint8_t b = 0;
+	uint8_t a = 255; // 0: nothing is drawn (GDI's TRANSPARENT background)
+
+	bool operator==(const Color& o) const { return r == o.r && g == o.g && b == o.b && a == o.a; }
+	bool operator!=(const Color& o) const { return !(*this == o); }
+
+	bool isTransparent() const { return a == 0; }
+	uint8_t gray() const { return static_cast<uint8_t>((r * 77 + g * 150 + b * 29) >> 8); }
+	uint32_t rgba() const { return static_cast<uint32_t>(r) | (static_cast<uint32_t>(g) << 8) | (static_cast<uint32_t>(b) << 16) | (static_cast<uint32_t>(a) << 24); }
+};
+
+inline Color rgb(int r, int g, int b) { return Color{ static_cast<uint8_t>(r), static_cast<uint8_t>(g), static_cast<uint8_t>(b), 255 }; }
+inline Color transparentColor() { return Color{ 0, 0, 0, 0 }; }
+
+// [left, right) x [top, bottom), same convention as RECT
+struct RectI {
+	int left = 0;
+	int top = 0;
+	int right = 0;
+	int bottom = 0;
+
+	int width()  const { return right - left; }
+	int height() const { return bottom - top; }
+	bool isEmpty() const { return right <= left || bottom <= top; }
+	bool contains(const RectI& o) const { return o.left >= left && o.top >= top && o.right <= right && o.bottom <= bottom; }
+
+	RectI intersect(const RectI& o) const {
+		RectI r{ left > o.left ? left : o.left, top > o.top ? top : o.top, right < o.right ? right : o.right, bottom < o.bottom ? bottom : o.bottom };
+		return r;
+	}
+};
+
+enum class TextAlign { Left, Center, Right };
+
+struct TextStyle {
+	Color text = rgb(0, 0, 0);
+	Color background = transparentColor();
+	int size = 0;	// character height in pixels, 0: the backend's default UI font
+	TextAlign align = TextAlign::Center;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+// Drawing backend used by the scene code in Scene.h; implemented with GDI in the Win32
+// front end and by SoftwareRenderer for headless frames.
+
+#include "CellLayer.h"
+#include "RenderTypes.h"
+#include <cstddef>
+
+class Renderer {
+public:
+	virtual ~Renderer() = default;
+
+	virtual void clear(Color c) = 0;
+	virtual void fillRect(const RectI& r, Color c) = 0;
+	virtual void frameRect(const RectI& r, Color c) = 0; // 1 pixel outline inside r
+	// n rects of one colour; backends with a brush state set it once for the lot
+	virtual void fillRects(const RectI* rects, size_t n, Color c) {
+		for (size_t i = 0; i < n; i++) fillRect(rects[i], c);
+	}
+	// single line, vertically centred in r and clipped to it; the background covers the text extent only
+	virtual void drawText(const RectI& r, const char* s, const TextStyle& style) = 0;
+	// hint that s will be drawn with this style on many frames; backends may cache its raster
+	virtual void prepareText(const char* /*s*/, const TextStyle& /*style*/) { }
+
+	// every non-empty cell as a filled square with a 1 pixel outline, cell (0, 0) at origin;
+	// backends that can do better than one square per cell override this
+	virtual void drawCells(const CellLayer& cells, int originX, int originY, int cellSize, const CellPalette& palette) {
+		for (int y = 0; y < cells.height(); y++) {
+			for (int x = 0; x < cells.width(); x++) {
+				CellClass k = cells.at(x, y);
+				if (k == CellClass::Empty) continue;
+				RectI r{ originX + x * cellSize, originY + y * cellSize, originX + (x + 1) * cellSize, originY + (y + 1) * cellSize };
+				fillRect(r, palette.fill[static_cast<int>(k)]);
+				frameRect(r, palette.outline);
+			}
+		}
+	}
+};
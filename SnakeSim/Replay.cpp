@@ -0,0 +1,222 @@
+#include "Replay.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace {
+	class BitWriter {
+		std::vector<uint8_t>& _out;
+		uint64_t _acc = 0;
+		int _nBits = 0;
+
+	public:
+		explicit BitWriter(std::vector<uint8_t>& out_) : _out(out_) { }
+
+		void put(uint64_t bits, int n) { // n <= 32
+			_acc |= bits << _nBits;
+			_nBits += n;
+			while (_nBits >= 8) {
+				_out.push_back(static_cast<uint8_t>(_acc));
+				_acc >>= 8;
+				_nBits -= 8;
+			}
+		}
+
+		// v >= 1: (bit length - 1) zeros, then v from its top bit down
+		void putGamma(uint64_t v) {
+			int len = 0;
+			while ((v >> len) > 1) len++;
+			put(0, len);
+			for (int i = len; i >= 0; i--) put((v >> i) & 1, 1);
+		}
+
+		void flush() { if (_nBits > 0) put(0, 8 - _nBits); }
+	};
+
+	class BitReader {
+		const uint8_t* _data;
+		size_t _size;
+		size_t _pos = 0; // in bits
+
+	public:
+		BitReader(const uint8_t* data_, size_t size_) : _data(data_), _size(size_) { }
+
+		bool get(int& bit) {
+			if (_pos >= _size * 8) return false;
+			bit = (_data[_pos >> 3] >> (_pos & 7)) & 1;
+			_pos++;
+			return true;
+		}
+
+		bool getGamma(uint64_t& v) {
+			int len = 0;
+			int bit = 0;
+			for (;;) {
+				if (!get(bit)) return false;
+				if (bit) break;
+				if (++len > 63) return false;
+			}
+			v = 1;
+			for (int i = 0; i < len; i++) {
+				if (!get(bit)) return false;
+				v = (v << 1) | static_cast<uint64_t>(bit);
+			}
+			return true;
+		}
+	};
+
+	void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+		while (v >= 0x80) {
+			out.push_back(static_cast<uint8_t>(v | 0x80));
+			v >>= 7;
+		}
+		out.push_back(static_cast<uint8_t>(v));
+	}
+
+	bool getVarint(const uint8_t* data, size_t size, size_t& pos, uint64_t& v) {
+		v = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			if (pos >= size) return false;
+			uint8_t b = data[pos++];
+			v |= static_cast<uint64_t>(b & 0x7F) << shift;
+			if (!(b & 0x80)) return true;
+		}
+		return false;
+	}
+
+	const uint8_t kMagic[4] = { 'S', 'N', 'K', 'R' };
+	const Direction kStartDirection = Direction::N; // GameSim::reset
+}
+
+std::vector<uint8_t> Replay::encode() const {
+	std::vector<uint8_t> out(kMagic, kMagic + 4);
+	out.push_back(kVersion);
+	putVarint(out, static_cast<uint64_t>(width));
+	putVarint(out, static_cast<uint64_t>(height));
+	for (int i = 0; i < 8; i++) out.push_back(static_cast<uint8_t>(seed >> (8 * i)));
+	putVarint(out, ticks);
+	putVarint(out, static_cast<uint64_t>(score));
+	putVarint(out, turns.size());
+
+	BitWriter bw(out);
+	uint64_t prevTick = 0;
+	Direction prevDir = kStartDirection;
+	for (const auto& t : turns) {
+		bw.putGamma(t.tick - prevTick); // turns happen on distinct ticks >= 1, the gap is >= 1
+		bw.put(t.dir == static_cast<Direction>((static_cast<int>(prevDir) + 1) % 4) ? 1 : 0, 1);
+		prevTick = t.tick;
+		prevDir = t.dir;
+	}
+	bw.flush();
+	return out;
+}
+
+bool Replay::decode(const uint8_t* data, size_t size, Replay& out) {
+	if (size < 5 || !std::equal(kMagic, kMagic + 4, data) || data[4] != kVersion) return false;
+
+	size_t pos = 5;
+	uint64_t w, h, t, s, n;
+	if (!getVarint(data, size, pos, w) || !getVarint(data, size, pos, h)) return false;
+	if (pos + 8 > size) return false;
+	uint64_t seed = 0;
+	for (int i = 0; i < 8; i++) seed |= static_cast<uint64_t>(data[pos++]) << (8 * i);
+	if (!getVarint(data, size, pos, t) || !getVarint(data, size, pos, s) || !getVarint(data, size, pos, n)) return false;
+	if (w == 0 || h == 0 || w > GameSim::kMaxBoardSide || h > GameSim::kMaxBoardSide || n > t) return false;
+
+	out.width = static_cast<int>(w);
+	out.height = static_cast<int>(h);
+	out.seed = seed;
+	out.ticks = t;
+	out.score = static_cast<int>(s);
+	out.turns.clear();
+	out.turns.reserve(static_cast<size_t>(n));
+
+	BitReader br(data + pos, size - pos);
+	uint64_t tick = 0;
+	Direction dir = kStartDirection;
+	for (uint64_t i = 0; i < n; i++) {
+		uint64_t gap;
+		int right;
+		if (!br.getGamma(gap) || !br.get(right)) return false;
+		tick += gap;
+		dir = static_cast<Direction>((static_cast<int>(dir) + (right ? 1 : 3)) % 4);
+		out.turns.push_back(TurnEvent{ tick, dir });
+	}
+	return true;
+}
+
+bool Replay::save(const std::string& path) const {
+	std::vector<uint8_t> bytes = encode();
+	std::ofstream f(path, std::ios::binary | std::ios::trunc);
+	f.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+	return static_cast<bool>(f);
+}
+
+bool Replay::load(const std::string& path, Replay& out) {
+	std::ifstream f(path, std::ios::binary);
+	if (!f) return false;
+	std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+	return decode(bytes.data(), bytes.size(), out);
+}
+
+void ReplayRecorder::begin(const GameSim& sim) {
+	_replay = Replay();
+	_replay.width = sim.width();
+	_replay.height = sim.height();
+	_replay.seed = sim.seed();
+	_dir = sim.getSnake().getCurrentDirection();
+	_isRecording = true;
+}
+
+void ReplayRecorder::onStep(const GameSim& sim) {
+	if (!_isRecording) return;
+	Direction d = sim.getSnake().getCurrentDirection();
+	if (d != _dir) {
+		_replay.turns.push_back(TurnEvent{ sim.ticks(), d });
+		_dir = d;
+	}
+	_replay.ticks = sim.ticks();
+	_replay.score = sim.score();
+}
+
+const Replay& ReplayRecorder::finish(const GameSim& sim) {
+	onStep(sim);
+	_isRecording = false;
+	return _replay;
+}
+
+ReplayPlayer::ReplayPlayer(const Replay& replay_, uint64_t keyframeInterval_)
+	: _replay(replay_), _sim(replay_.width, replay_.height, replay_.seed), _keyframeInterval(keyframeInterval_ ? keyframeInterval_ : 1)
+{
+	_keyframes.push_back(Keyframe{ _sim, 0 });
+}
+
+bool ReplayPlayer::stepForward() {
+	if (_sim.isOver() || _sim.ticks() >= _replay.ticks) return false;
+
+	uint64_t next = _sim.ticks() + 1;
+	Action a = Action::None;
+	if (_nextTurn < _replay.turns.size() && _replay.turns[_nextTurn].tick == next) {
+		a = static_cast<Action>(_replay.turns[_nextTurn].dir);
+		_nextTurn++;
+	}
+	_sim.step(a);
+
+	if (next % _keyframeInterval == 0 && next / _keyframeInterval == _keyframes.size()) {
+		_keyframes.push_back(Keyframe{ _sim, _nextTurn });
+	}
+	return true;
+}
+
+void ReplayPlayer::seek(uint64_t tick) {
+	if (tick > _replay.ticks) tick = _replay.ticks;
+
+	// restore when going back, or when a snapshot is closer than where we are
+	size_t k = static_cast<size_t>(tick / _keyframeInterval);
+	if (k >= _keyframes.size()) k = _keyframes.size() - 1;
+	if (tick < _sim.ticks() || k * _keyframeInterval > _sim.ticks()) {
+		_sim = _keyframes[k].sim;
+		_nextTurn = _keyframes[k].nextTurn;
+	}
+	while (_sim.ticks() < tick && stepForward()) { }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+// Replays: the seed plus the turns the snake actually took, which is all GameSim needs
+// to re-run a game bit for bit.
+//
+// Encoded layout (little endian):
+//   "SNKR" | version u8 | width, height varint | seed u64 | ticks, score, nTurns varint | turn bits
+// Turn bits: per turn, Elias-gamma(ticks since the previous turn) then 1 bit (0 = left, 1 = right).
+// A turn is always a quarter turn (same and opposite directions are no-ops), so 1 bit is enough,
+// and the gap code is what run-length encodes the straight ticks in between.
+
+#include "GameSim.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct TurnEvent {
+	uint64_t tick = 0;	// the step() that made ticks() == tick moved in dir
+	Direction dir = Direction::N;
+};
+
+struct Replay {
+	static constexpr uint8_t kVersion = 1;
+
+	int width = 20;
+	int height = 20;
+	uint64_t seed = 0;
+	uint64_t ticks = 0;	// length of the recorded game
+	int score = 0;		// final score, for indexing and validation
+	std::vector<TurnEvent> turns;
+
+	std::vector<uint8_t> encode() const;
+	static bool decode(const uint8_t* data, size_t size, Replay& out);
+
+	bool save(const std::string& path) const;
+	static bool load(const std::string& path, Replay& out);
+};
+
+// Watches a GameSim between steps and records every direction change the snake moved with,
+// whether it came from step(action) or from Snake::setDirection (keyboard).
+class ReplayRecorder {
+	Replay _replay;
+	Direction _dir = Direction::N;
+	bool _isRecording = false;
+
+public:
+	void begin(const GameSim& sim);
+	void onStep(const GameSim& sim);
+	const Replay& finish(const GameSim& sim);
+
+	bool isRecording() const { return _isRecording; }
+	const Replay& replay() const { return _replay; }
+};
+
+// Re-simulates a replay. Snapshots of the game are kept every keyframeInterval ticks while
+// playing forward, so seeking backwards restarts from the nearest snapshot instead of tick 0.
+class ReplayPlayer {
+	struct Keyframe {
+		GameSim sim;
+		size_t nextTurn;
+	};
+
+	Replay _replay;
+	GameSim _sim;
+	size_t _nextTurn = 0;
+	uint64_t _keyframeInterval;
+	std::vector<Keyframe> _keyframes; // _keyframes[k] is tick k * _keyframeInterval
+
+public:
+	explicit ReplayPlayer(const Replay& replay_, uint64_t keyframeInterval_ = 1024);
+
+	// false once the recorded length is reached or the game is over
+	bool stepForward();
+
+	// tick is clamped to the recorded length
+	void seek(uint64_t tick);
+
+	const GameSim&	sim()		const { return _sim; }
+	uint64_t		tick()		const { return _sim.ticks(); }
+	const Replay&	replay()	const { return _replay; }
+	size_t			nKeyframes() const { return _keyframes.size(); }
+};
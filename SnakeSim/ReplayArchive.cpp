@@ -0,0 +1,213 @@
+#include "ReplayArchive.h"
+#include <cstring>
+
+namespace {
+	// the index must end right at the footer; compared without sums or products that could
+	// wrap, so a corrupt footer cannot point the entries past the file
+	bool indexFits(const ArchiveFooter& footer, uint64_t size) {
+		if (size < sizeof(footer)) return false;
+		const uint64_t room = size - sizeof(footer);
+		return footer.count <= room / sizeof(ArchiveEntry) && footer.indexOffset == room - footer.count * sizeof(ArchiveEntry);
+	}
+
+	bool entriesFit(const ArchiveEntry* entries, const ArchiveFooter& footer) {
+		for (uint64_t i = 0; i < footer.count; i++) {
+			const ArchiveEntry& e = entries[i];
+			if (e.offset > footer.indexOffset || e.length > footer.indexOffset - e.offset) return false;
+		}
+		return true;
+	}
+
+	// End of the newest complete footer: the end of the file, unless an append never got to
+	// its flush (a crash, a full disk) and left a torn tail, in which case the last footer
+	// before it still describes every replay flushed until then. 0 for no archive.
+	uint64_t findFooter(const uint8_t* data, uint64_t size, ArchiveFooter& footer) {
+		for (uint64_t end = size; end >= sizeof(footer); end--) {
+			std::memcpy(&footer, data + end - sizeof(footer), sizeof(footer));
+			if (footer.magic == ReplayArchiveWriter::kMagic && footer.version == ReplayArchiveWriter::kVersion && indexFits(footer, end)
+				&& entriesFit(reinterpret_cast<const ArchiveEntry*>(data + footer.indexOffset), footer)) return end;
+		}
+		return 0;
+	}
+}
+
+uint32_t ReplayArchiveWriter::defaultDurationMs(uint64_t ticks) {
+	return ticks > UINT32_MAX / kDefaultTickMs ? UINT32_MAX : static_cast<uint32_t>(ticks * kDefaultTickMs);
+}
+
+bool ReplayArchiveWriter::open(const std::filesystem::path& path) {
+	close();
+	_path = path;
+	_entries.clear();
+	_end = 0;
+	_dead = 0;
+
+	std::error_code ec;
+	const uintmax_t size = std::filesystem::file_size(path, ec);
+	if (ec || size == 0) {
+		// new archive
+		_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		_file.close();
+		_file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+		_isDirty = true;
+		return static_cast<bool>(_file);
+	}
+
+	MappedFile map;
+	if (!map.open(path)) return false;
+	ArchiveFooter footer;
+	const uint64_t end = findFooter(map.data(), map.size(), footer);
+	if (end == 0) return false;
+	const ArchiveEntry* entries = reinterpret_cast<const ArchiveEntry*>(map.data() + footer.indexOffset);
+	_entries.assign(entries, entries + footer.count);
+	map.close();
+
+	// a torn tail is written over
+	_end = end;
+	_dead = _end - liveBytes();
+	_file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+	return static_cast<bool>(_file);
+}
+
+uint64_t ReplayArchiveWriter::liveBytes() const {
+	uint64_t bytes = sizeof(ArchiveFooter) + _entries.size() * sizeof(ArchiveEntry);
+	for (const ArchiveEntry& e : _entries) bytes += e.length;
+	return bytes;
+}
+
+// after the last footer, which stays valid until flush() writes the next one
+bool ReplayArchiveWriter::append(const Replay& replay, uint32_t durationMs) {
+	if (!_file.is_open()) return false;
+	std::vector<uint8_t> bytes = replay.encode();
+
+	_file.clear();
+	_file.seekp(static_cast<std::streamoff>(_end));
+	_file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+	if (!_file) return false;
+
+	ArchiveEntry e;
+	e.offset = _end;
+	e.seed = replay.seed;
+	e.ticks = replay.ticks;
+	e.length = static_cast<uint32_t>(bytes.size());
+	e.score = static_cast<uint32_t>(replay.score);
+	e.durationMs = durationMs ? durationMs : defaultDurationMs(replay.ticks);
+	e.reserved = 0;
+	_entries.push_back(e);
+	_end += bytes.size();
+	_isDirty = true;
+	return true;
+}
+
+bool ReplayArchiveWriter::flush() {
+	if (!_file.is_open()) return false;
+	if (!_isDirty) return true;
+	if (!writeIndex(_file, _end)) return false;
+
+	// the index and footer just written are dead as soon as the next one follows them
+	_end += _entries.size() * sizeof(ArchiveEntry) + sizeof(ArchiveFooter);
+	_isDirty = false;
+	const uint64_t live = liveBytes();
+	_dead = _end - live;
+	if (_dead > live && _dead > kCompactSlack) compact();
+	return true;
+}
+
+bool ReplayArchiveWriter::writeIndex(std::fstream& file, uint64_t at) const {
+	ArchiveFooter footer;
+	footer.magic = kMagic;
+	footer.version = kVersion;
+	footer.count = _entries.size();
+	footer.indexOffset = at;
+
+	file.clear();
+	file.seekp(static_cast<std::streamoff>(at));
+	file.write(reinterpret_cast<const char*>(_entries.data()), static_cast<std::streamsize>(_entries.size() * sizeof(ArchiveEntry)));
+	file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+	file.flush();
+	return static_cast<bool>(file);
+}
+
+// Copies the live replays into a new file next to the archive and renames it into place.
+// Any failure keeps the current archive, which is complete at this point.
+void ReplayArchiveWriter::compact() {
+	std::filesystem::path tmp = _path;
+	tmp += ".tmp";
+	std::vector<ArchiveEntry> entries = _entries;
+	{
+		std::fstream out(tmp, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+		std::vector<char> bytes;
+		uint64_t at = 0;
+		for (ArchiveEntry& e : entries) {
+			bytes.resize(e.length);
+			_file.clear();
+			_file.seekg(static_cast<std::streamoff>(e.offset));
+			_file.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+			out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+			e.offset = at;
+			at += e.length;
+		}
+		std::swap(entries, _entries);
+		const bool written = _file && writeIndex(out, at);
+		std::swap(entries, _entries);
+		if (!written) {
+			out.close();
+			std::error_code ec;
+			std::filesystem::remove(tmp, ec);
+			return;
+		}
+	}
+
+	_file.close(); // Windows does not rename over an open file
+	std::error_code ec;
+	std::filesystem::rename(tmp, _path, ec);
+	if (ec) {
+		std::filesystem::remove(tmp, ec);
+	} else {
+		for (size_t i = 0; i < _entries.size(); i++) _entries[i].offset = entries[i].offset;
+		_end = liveBytes();
+		_dead = 0;
+	}
+	_file.open(_path, std::ios::in | std::ios::out | std::ios::binary);
+}
+
+void ReplayArchiveWriter::close() {
+	if (!_file.is_open()) return;
+	flush();
+	_file.close();
+}
+
+bool ReplayArchive::open(const std::filesystem::path& path) {
+	close();
+	if (!_file.open(path)) return false;
+
+	// a torn tail (a writer that died between append and flush) is left unread
+	ArchiveFooter footer;
+	if (findFooter(_file.data(), _file.size(), footer) == 0) { close(); return false; }
+	_count = static_cast<size_t>(footer.count);
+	_entries = reinterpret_cast<const ArchiveEntry*>(_file.data() + footer.indexOffset);
+	return true;
+}
+
+void ReplayArchive::close() {
+	_file.close();
+	_entries = nullptr;
+	_count = 0;
+}
+
+std::vector<size_t> ReplayArchive::select(const Filter& filter) const {
+	std::vector<size_t> out;
+	for (size_t i = 0; i < _count; i++) {
+		if (filter.accepts(_entries[i])) out.push_back(i);
+	}
+	return out;
+}
+
+void ReplayArchive::forEach(ParallelRunner& runner, const Filter& filter, const EntryFn& fn, size_t grain) const {
+	runner.parallelFor(_count, grain, [&](size_t begin, size_t end, unsigned t) {
+		for (size_t i = begin; i < end; i++) {
+			const ArchiveEntry& e = _entries[i];
+			if (filter.accepts(e)) fn(i, e, _file.data() + e.offset, t);
+		}
+	});
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+// Archive of encoded replays with an index in the footer:
+//   [replay 0][replay 1]...[ArchiveEntry x count][ArchiveFooter]
+// Appends never overwrite anything: a replay goes after the last footer and flush() writes
+// the whole index and a new footer after it, so until that footer is complete the previous
+// one still ends a readable archive. Readers and writers take the newest complete footer,
+// leaving a torn tail from a crash or a full disk unread. The index and footer copies left
+// behind are dead bytes; once they outweigh the live ones the writer copies the replays to
+// a new file and renames it into place.
+// Readers map the file and use the entries and replay bytes in place, no parsing or copying.
+// Fields are little endian; the structs are used as-is on little endian hosts.
+
+#include "MappedFile.h"
+#include "ParallelRunner.h"
+#include "Replay.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <vector>
+
+#pragma pack(push, 1)
+struct ArchiveEntry {
+	uint64_t offset;		// of the encoded replay
+	uint64_t seed;
+	uint64_t ticks;
+	uint32_t length;		// encoded bytes
+	uint32_t score;
+	uint32_t durationMs;	// play time, ticks * tick length for headless games
+	uint32_t reserved;
+};
+
+struct ArchiveFooter {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t count;
+	uint64_t indexOffset;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(ArchiveEntry) == 40, "ArchiveEntry layout is part of the file format");
+static_assert(sizeof(ArchiveFooter) == 24, "ArchiveFooter layout is part of the file format");
+
+class ReplayArchiveWriter {
+	std::filesystem::path _path;
+	std::fstream _file;
+	std::vector<ArchiveEntry> _entries;
+	uint64_t _end = 0;	// where the next replay goes: after the last footer or replay written
+	uint64_t _dead = 0;	// bytes before _end no footer will point to again
+	bool _isDirty = false;
+
+	uint64_t liveBytes() const; // replays, one index and one footer
+	bool writeIndex(std::fstream& file, uint64_t at) const;
+	void compact();
+
+public:
+	static constexpr uint32_t kMagic = 0x414B4E53; // "SNKA"
+	static constexpr uint32_t kVersion = 1;
+	static constexpr uint32_t kDefaultTickMs = 100;
+	static constexpr uint64_t kCompactSlack = 1 << 20; // dead bytes always tolerated
+
+	ReplayArchiveWriter() = default;
+	explicit ReplayArchiveWriter(const std::filesystem::path& path) { open(path); }
+	~ReplayArchiveWriter() { close(); }
+
+	// opens an existing archive for appending or creates a new one; a path, so per-user
+	// folders with non-ASCII names open on Windows too
+	bool open(const std::filesystem::path& path);
+
+	// ticks * kDefaultTickMs, saturated at UINT32_MAX (about 50 days)
+	static uint32_t defaultDurationMs(uint64_t ticks);
+
+	// durationMs = 0: defaultDurationMs(replay.ticks)
+	bool append(const Replay& replay, uint32_t durationMs = 0);
+
+	// writes index + footer after the appended replays; they are readable after this
+	bool flush();
+	void close();
+
+	size_t count() const { return _entries.size(); }
+	uint64_t deadBytes() const { return _dead; }
+};
+
+class ReplayArchive {
+	MappedFile _file;
+	const ArchiveEntry* _entries = nullptr;
+	size_t _count = 0;
+
+public:
+	struct Filter {
+		uint32_t minScore = 0;
+		uint32_t maxScore = UINT32_MAX;
+		uint32_t minDurationMs = 0;
+		uint32_t maxDurationMs = UINT32_MAX;
+
+		bool accepts(const ArchiveEntry& e) const {
+			return e.score >= minScore && e.score <= maxScore && e.durationMs >= minDurationMs && e.durationMs <= maxDurationMs;
+		}
+	};
+
+	// fn(index, entry, encoded replay bytes, thread)
+	typedef std::function<void(size_t, const ArchiveEntry&, const uint8_t*, unsigned)> EntryFn;
+
+	ReplayArchive() = default;
+	explicit ReplayArchive(const std::filesystem::path& path) { open(path); }
+
+	// a path like the writer's, so an archive it wrote anywhere can be read back
+	bool open(const std::filesystem::path& path);
+	void close();
+	bool isOpen() const { return _file.isOpen(); }
+
+	size_t count() const { return _count; }
+	const ArchiveEntry& entry(size_t i) const { return _entries[i]; }
+	const uint8_t* replayData(size_t i) const { return _file.data() + _entries[i].offset; }
+	bool decode(size_t i, Replay& out) const { return Replay::decode(replayData(i), _entries[i].length, out); }
+
+	std::vector<size_t> select(const Filter& filter) const;
+
+	// visits every entry accepted by filter, spread over runner's threads
+	void forEach(ParallelRunner& runner, const Filter& filter, const EntryFn& fn, size_t grain = 1024) const;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+// Fixed-capacity circular deque: push at the front, pop at the back, O(1) random access.
+// Capacity is rounded up to a power of two so wrapping is a mask.
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+template<class T>
+class RingBuffer {
+	std::vector<T> _buf;
+	size_t _mask = 0;
+	size_t _front = 0; // slot of element 0
+	size_t _size = 0;
+
+public:
+	RingBuffer() = default;
+	explicit RingBuffer(size_t capacity_) { reset(capacity_); }
+
+	// drops all elements; keeps the allocation when it is already large enough
+	void reset(size_t capacity_) {
+		size_t c = 1;
+		while (c < capacity_) c <<= 1;
+		if (c != _buf.size()) _buf.assign(c, T{});
+		_mask = c - 1;
+		_front = 0;
+		_size = 0;
+	}
+
+	void clear() { _front = 0; _size = 0; }
+
+	// grows to at least capacity_ keeping the elements (element 0 moves to slot 0)
+	void reserve(size_t capacity_) {
+		if (capacity_ <= _buf.size()) return;
+		size_t c = _buf.empty() ? 1 : _buf.size();
+		while (c < capacity_) c <<= 1;
+		std::vector<T> buf(c);
+		for (size_t i = 0; i < _size; i++) buf[i] = (*this)[i];
+		_buf.swap(buf);
+		_mask = c - 1;
+		_front = 0;
+	}
+
+	void pushFront(const T& v) {
+		assert(_size < _buf.size() && "ring buffer is full");
+		_front = (_front - 1) & _mask;
+		_buf[_front] = v;
+		_size++;
+	}
+
+	void pushBack(const T& v) {
+		assert(_size < _buf.size() && "ring buffer is full");
+		_buf[(_front + _size) & _mask] = v;
+		_size++;
+	}
+
+	void popBack() {
+		assert(_size > 0);
+		_size--;
+	}
+
+	// i = 0 is the front
+	const T& operator[](size_t i) const { return _buf[(_front + i) & _mask]; }
+	T& operator[](size_t i) { return _buf[(_front + i) & _mask]; }
+
+	const T& front() const { return (*this)[0]; }
+	const T& back()	 const { return (*this)[_size - 1]; }
+
+	size_t size()		const { return _size; }
+	size_t capacity()	const { return _buf.size(); }
+	bool empty()		const { return _size == 0; }
+	bool full()			const { return _size == _buf.size(); }
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+// xoshiro256** generator, one per game: explicit seed, no shared state, trivially copyable,
+// so any episode can be replayed bit for bit from its seed.
+// jump() advances 2^128 draws, split() hands out non-overlapping streams for parallel games.
+
+#include <cstdint>
+
+class Rng {
+	uint64_t _s[4];
+
+	static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+	void applyJump(const uint64_t (&poly)[4]) {
+		uint64_t t[4] = { 0, 0, 0, 0 };
+		for (int i = 0; i < 4; i++) {
+			for (int b = 0; b < 64; b++) {
+				if (poly[i] & (uint64_t(1) << b)) {
+					t[0] ^= _s[0];
+					t[1] ^= _s[1];
+					t[2] ^= _s[2];
+					t[3] ^= _s[3];
+				}
+				next();
+			}
+		}
+		_s[0] = t[0];
+		_s[1] = t[1];
+		_s[2] = t[2];
+		_s[3] = t[3];
+	}
+
+public:
+	explicit Rng(uint64_t seed_ = 0) { seed(seed_); }
+	// the raw generator state, not all zero; for the reference test vectors
+	explicit Rng(const uint64_t (&state_)[4]) : _s{ state_[0], state_[1], state_[2], state_[3] } { }
+
+	static uint64_t splitmix64(uint64_t& state) {
+		uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	// expands the 64 bit seed with splitmix64, never yields the all-zero state
+	void seed(uint64_t seed_) {
+		uint64_t sm = seed_;
+		for (int i = 0; i < 4; i++) _s[i] = splitmix64(sm);
+	}
+
+	uint64_t next() {
+		uint64_t result = rotl(_s[1] * 5, 7) * 9;
+		uint64_t t = _s[1] << 17;
+		_s[2] ^= _s[0];
+		_s[3] ^= _s[1];
+		_s[1] ^= _s[2];
+		_s[0] ^= _s[3];
+		_s[2] ^= t;
+		_s[3] = rotl(_s[3], 45);
+		return result;
+	}
+
+	uint32_t next32() { return static_cast<uint32_t>(next() >> 32); }
+
+	// unbiased value in [0, n), n > 0 (Lemire's multiply-shift with rejection)
+	uint32_t below(uint32_t n) {
+		uint64_t m = static_cast<uint64_t>(next32()) * n;
+		uint32_t low = static_cast<uint32_t>(m);
+		if (low < n) {
+			uint32_t threshold = static_cast<uint32_t>(-n) % n;
+			while (low < threshold) {
+				m = static_cast<uint64_t>(next32()) * n;
+				low = static_cast<uint32_t>(m);
+			}
+		}
+		return static_cast<uint32_t>(m >> 32);
+	}
+
+	// unbiased value in [from, to]
+	int nextInt(int from, int to) {
+		uint32_t span = static_cast<uint32_t>(static_cast<int64_t>(to) - from + 1);
+		return static_cast<int>(static_cast<int64_t>(from) + below(span));
+	}
+
+	// equivalent to 2^128 calls to next()
+	void jump() {
+		static const uint64_t poly[4] = { 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+		applyJump(poly);
+	}
+
+	// equivalent to 2^192 calls to next()
+	void longJump() {
+		static const uint64_t poly[4] = { 0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL, 0x77710069854EE241ULL, 0x39109BB02ACBE635ULL };
+		applyJump(poly);
+	}
+
+	// returns the current stream and moves this generator 2^128 draws ahead
+	Rng split() {
+		Rng r = *this;
+		jump();
+		return r;
+	}
+
+	bool operator==(const Rng& o) const { return _s[0] == o._s[0] && _s[1] == o._s[1] && _s[2] == o._s[2] && _s[3] == o._s[3]; }
+	bool operator!=(const Rng& o) const { return !(*this == o); }
+};
@@ -0,0 +1,269 @@
+#include "Scene.h"
+#include <cstdio>
+
+namespace {
+	// overlay messages, the same every frame
+	const char* const kYouWin = "You Win";
+	const char* const kGameOver = "Game Over";
+	const char* const kPressSpaceContinue = "Press <SPACE> To continue";
+	const char* const kPressEscRestart = "Press <ESC> To restart";
+	const char* const kPause = "Pause";
+	const char* const kPressSpaceResume = "Press <SPACE> to resume";
+}
+
+void Scene::formatDuration(char* buff, size_t size, int elapsedSec) {
+	if (!buff || size == 0) return;
+	int n_min = elapsedSec / 60;
+	int n_s = elapsedSec % 60;
+	char c = n_s % 2 ? ' ' : ':'; // flashing
+	snprintf(buff, size, "%02d%c%02d", n_min, c, n_s);
+}
+
+void Scene::prepareText(Renderer& r, const SceneStyle& s) {
+	TextStyle ts;
+	ts.text = s.gameOverText;
+	ts.background = s.gameOverBackground;
+	r.prepareText(kYouWin, ts);
+	r.prepareText(kGameOver, ts);
+
+	ts.text = s.messageText;
+	ts.background = s.messageBackground;
+	r.prepareText(kPressSpaceContinue, ts);
+	r.prepareText(kPressEscRestart, ts);
+	r.prepareText(kPause, ts);
+	r.prepareText(kPressSpaceResume, ts);
+}
+
+void Scene::drawGamePlay(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, const SceneState& st) {
+	drawLayout(r, l, s);
+	drawGamePlayUi(r, l, s, sim.score(), st.elapsedSec, st.status);
+	drawSnake(r, l, s, sim.getSnake());
+	drawBait(r, l, s, sim.getBait());
+	if (st.tickAlpha > 0.0f) { drawMotion(r, l, s, sim, st.tickAlpha); }
+	if (st.isPaused) { drawPause(r, l, s); }
+}
+
+void Scene::drawGamePlay(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, const SceneState& st, CellLayer& cells) {
+	drawLayout(r, l, s);
+	drawGamePlayUi(r, l, s, sim.score(), st.elapsedSec, st.status);
+	cells.build(sim);
+	drawBoard(r, l, s, cells);
+	if (st.tickAlpha > 0.0f) { drawMotion(r, l, s, sim, st.tickAlpha); }
+	if (st.isPaused) { drawPause(r, l, s); }
+}
+
+void Scene::drawGameOver(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, const SceneState& st) {
+	drawGamePlay(r, l, s, sim, st);
+
+	RectI cr = l.clientRect;
+	TextStyle ts;
+	ts.text = s.gameOverText;
+	ts.background = s.gameOverBackground;
+	r.drawText(cr, sim.isWon() ? kYouWin : kGameOver, ts); // board filled
+
+	ts.text = s.messageText;
+	ts.background = s.messageBackground;
+	cr.top += (cr.bottom - cr.top) / 3;
+	r.drawText(cr, kPressSpaceContinue, ts);
+	cr.top += (cr.bottom - cr.top) / 5;
+	r.drawText(cr, kPressEscRestart, ts);
+}
+
+void Scene::drawDirty(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, const SceneState& st, SceneCache& shown) {
+	if (!shown.valid || sim.dirty().all() || st.isPaused != shown.isPaused) {
+		r.fillRect(l.clientRect, s.background);
+		drawGamePlay(r, l, s, sim, st);
+	}
+	else {
+		const DirtyCells& dirty = sim.dirty();
+		for (int i = 0; i < dirty.size(); i++) {
+			drawCell(r, l, s, sim, dirty[i]);
+		}
+		if (st.tickAlpha > 0.0f || shown.nMotion > 0) {
+			Cell moving[2];
+			int n = st.tickAlpha > 0.0f ? motionCells(sim, moving) : 0;
+			for (int i = 0; i < shown.nMotion; i++) drawCell(r, l, s, sim, shown.motion[i]);
+			for (int i = 0; i < n; i++) drawCell(r, l, s, sim, moving[i]);
+			if (n > 0) drawMotion(r, l, s, sim, st.tickAlpha);
+		}
+		if (shown.uiChanged(sim.score(), st.elapsedSec, st.status)) {
+			drawUiBar(r, l, s, sim.score(), st.elapsedSec, st.status);
+		}
+		if (st.isPaused && dirty.size() > 0) { drawPause(r, l, s); } // cells may sit under the overlay
+	}
+	shown.setUi(sim.score(), st.elapsedSec, st.status);
+	shown.isPaused = st.isPaused;
+	shown.nMotion = st.tickAlpha > 0.0f ? motionCells(sim, shown.motion) : 0;
+}
+
+void Scene::drawRegion(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, const SceneState& st, const RectI& region) {
+	drawRegion(r, l, s, sim, st, &region, 1);
+}
+
+void Scene::drawRegion(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, const SceneState& st, const RectI* rects, int nRects) {
+	bool touchesUi = false;
+	bool touchesGame = false;
+	for (int i = 0; i < nRects; i++) {
+		if (rects[i].contains(l.uiRect) && rects[i].contains(l.gameRect)) { // whole window: one square per object is cheaper
+			r.fillRect(l.clientRect, s.background);
+			drawGamePlay(r, l, s, sim, st);
+			return;
+		}
+		touchesUi = touchesUi || !rects[i].intersect(l.uiRect).isEmpty();
+		touchesGame = touchesGame || !rects[i].intersect(l.gameRect).isEmpty();
+	}
+	if (touchesUi) {
+		drawUiBar(r, l, s, sim.score(), st.elapsedSec, st.status);
+	}
+	for (int i = 0; i < nRects; i++) {
+		RectI gr = rects[i].intersect(l.gameRect);
+		if (gr.isEmpty()) continue;
+		int x0 = (gr.left - l.gameRect.left) / l.cellSize;
+		int y0 = (gr.top - l.gameRect.top) / l.cellSize;
+		int x1 = (gr.right - l.gameRect.left + l.cellSize - 1) / l.cellSize;
+		int y1 = (gr.bottom - l.gameRect.top + l.cellSize - 1) / l.cellSize;
+		for (int y = y0; y < y1; y++) {
+			for (int x = x0; x < x1; x++) {
+				drawCell(r, l, s, sim, Cell{ x, y });
+			}
+		}
+	}
+	if (touchesGame && st.tickAlpha > 0.0f) { drawMotion(r, l, s, sim, st.tickAlpha); }
+	if (st.isPaused) { drawPause(r, l, s); }
+}
+
+void Scene::drawLayout(Renderer& r, const SceneLayout& l, const SceneStyle& s) {
+	r.frameRect(l.uiRect, s.layoutLine);
+	r.frameRect(l.gameRect, s.layoutLine);
+}
+
+void Scene::drawGamePlayUi(Renderer& r, const SceneLayout& l, const SceneStyle& s, int score, int elapsedSec, const char* status) {
+	RectI ur = l.uiRect;
+	int xoffset = 10;
+	ur.left += xoffset;
+	ur.right -= xoffset;
+
+	char buff[32];
+	TextStyle ts;
+	ts.text = s.uiText;
+
+	snprintf(buff, sizeof(buff), "Score: %d", score);
+	ts.background = s.scoreBackground;
+	ts.align = TextAlign::Left;
+	r.drawText(ur, buff, ts);
+
+	formatDuration(buff, sizeof(buff), elapsedSec);
+	ts.background = s.timeBackground;
+	ts.align = TextAlign::Right;
+	r.drawText(ur, buff, ts);
+
+	if (status && *status) {
+		ts.background = s.timeBackground;
+		ts.align = TextAlign::Center;
+		r.drawText(ur, status, ts);
+	}
+}
+
+void Scene::drawUiBar(Renderer& r, const SceneLayout& l, const SceneStyle& s, int score, int elapsedSec, const char* status) {
+	r.fillRect(l.uiRect, s.background);
+	r.frameRect(l.uiRect, s.layoutLine);
+	drawGamePlayUi(r, l, s, score, elapsedSec, status);
+}
+
+void Scene::drawCell(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, const Cell& c) {
+	if (!sim.isInside(c)) return;
+	RectI rect = l.cellRect(c);
+
+	// same precedence as drawGamePlay: bait over head over body
+	if (c == sim.getBait().getPos())			{ drawSquare(r, rect, s.bait, s.cellOutline); return; }
+	if (c == sim.getSnake().getHead())			{ drawSquare(r, rect, s.snakeHead, s.cellOutline); return; }
+	if (!sim.getBoard().isFree(c))				{ drawSquare(r, rect, s.snakeBody, s.cellOutline); return; }
+
+	drawEmpty(r, l, s, rect);
+}
+
+void Scene::drawEmpty(Renderer& r, const SceneLayout& l, const SceneStyle& s, const RectI& rect) {
+	r.fillRect(rect, s.background);
+	const RectI& g = l.gameRect;
+	RectI edges[4] = {
+		RectI{ g.left, g.top, g.right, g.top + 1 },
+		RectI{ g.left, g.bottom - 1, g.right, g.bottom },
+		RectI{ g.left, g.top, g.left + 1, g.bottom },
+		RectI{ g.right - 1, g.top, g.right, g.bottom },
+	};
+	for (const RectI& e : edges) {
+		RectI piece = e.intersect(rect);
+		if (!piece.isEmpty()) r.fillRect(piece, s.layoutLine);
+	}
+}
+
+namespace {
+	// the `len` pixels of `rect` on its `d` side
+	RectI sideOf(const RectI& rect, Direction d, int len) {
+		switch (d) {
+			case Direction::N: return RectI{ rect.left, rect.top, rect.right, rect.top + len };
+			case Direction::S: return RectI{ rect.left, rect.bottom - len, rect.right, rect.bottom };
+			case Direction::W: return RectI{ rect.left, rect.top, rect.left + len, rect.bottom };
+			default:		   return RectI{ rect.right - len, rect.top, rect.right, rect.bottom };
+		}
+	}
+
+	Direction towards(const Cell& from, const Cell& to) {
+		if (to.x > from.x) return Direction::E;
+		if (to.x < from.x) return Direction::W;
+		return to.y > from.y ? Direction::S : Direction::N;
+	}
+}
+
+int Scene::motionCells(const GameSim& sim, Cell out[2]) {
+	const Snake& snake = sim.getSnake();
+	int n = 0;
+	if (sim.isOver()) return 0;
+	if (sim.isInside(snake.getNextPos())) out[n++] = snake.getNextPos();
+	if (snake.getPendingGrowth() == 0 && snake.nSegments() > 1) out[n++] = snake.getTail();
+	return n;
+}
+
+void Scene::drawMotion(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, float alpha) {
+	const Snake& snake = sim.getSnake();
+	int len = static_cast<int>(alpha * static_cast<float>(l.cellSize));
+	if (sim.isOver() || len <= 0) return;
+	if (len > l.cellSize) len = l.cellSize;
+
+	// tail first: when the head chases it, the head wins the shared cell
+	if (snake.getPendingGrowth() == 0 && snake.nSegments() > 1) {
+		Cell tail = snake.getTail();
+		Direction away = oppositeDirection(towards(tail, snake.getSegment(snake.nSegments() - 2)));
+		drawEmpty(r, l, s, sideOf(l.cellRect(tail), away, len));
+	}
+	Cell next = snake.getNextPos();
+	if (sim.isInside(next)) {
+		Direction back = oppositeDirection(snake.getCurrentDirection());
+		drawSquare(r, sideOf(l.cellRect(next), back, len), s.snakeHead, s.cellOutline);
+	}
+}
+
+void Scene::drawSnake(Renderer& r, const SceneLayout& l, const SceneStyle& s, const Snake& snake) {
+	for (size_t i = 1; i < snake.nSegments(); i++) {
+		drawSquare(r, l.cellRect(snake.getSegment(i)), s.snakeBody, s.cellOutline); //draw body
+	}
+	drawSquare(r, l.cellRect(snake.getHead()), s.snakeHead, s.cellOutline); //draw head, always on top;
+}
+
+void Scene::drawBait(Renderer& r, const SceneLayout& l, const SceneStyle& s, const Bait& bait) {
+	drawSquare(r, l.cellRect(bait.getPos()), s.bait, s.cellOutline);
+}
+
+void Scene::drawBoard(Renderer& r, const SceneLayout& l, const SceneStyle& s, const CellLayer& cells) {
+	r.drawCells(cells, l.gameRect.left, l.gameRect.top, l.cellSize, s.cellPalette());
+}
+
+void Scene::drawPause(Renderer& r, const SceneLayout& l, const SceneStyle& s) {
+	RectI cr = l.clientRect;
+	TextStyle ts;
+	ts.text = s.messageText;
+	ts.background = s.messageBackground;
+	r.drawText(cr, kPause, ts);
+	cr.top += (cr.bottom - cr.top) / 4;
+	r.drawText(cr, kPressSpaceResume, ts);
+}
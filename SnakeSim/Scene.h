@@ -0,0 +1,133 @@
+#pragma once
+
+// The game play scene (layout boxes, UI bar, snake, bait and overlays) drawn through any
+// Renderer, so GDI and headless frames show the same picture.
+
+#include "GameSim.h"
+#include "Renderer.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+struct SceneLayout {
+	RectI clientRect;
+	RectI uiRect;	// score / time bar on top
+	RectI gameRect;	// the board, below the bar
+	int cellSize = 30;
+
+	// same boxes as GameLayout::init, without the window frame
+	void init(int cell_size = 30, int n_cells_per_side = 20) {
+		cellSize = cell_size;
+		int side = cell_size * n_cells_per_side;
+		uiRect = RectI{ 0, 0, side, cell_size };
+		gameRect = RectI{ 0, cell_size, side, cell_size + side };
+		clientRect = RectI{ 0, 0, side, cell_size + side };
+	}
+
+	RectI cellRect(const Cell& c) const {
+		int x = gameRect.left + c.x * cellSize;
+		int y = gameRect.top + c.y * cellSize;
+		return RectI{ x, y, x + cellSize, y + cellSize };
+	}
+};
+
+struct SceneStyle {
+	Color background		= rgb(0, 0, 0);
+	Color layoutLine		= rgb(127, 127, 127);
+	Color cellOutline		= rgb(0, 0, 0);
+	Color snakeHead			= rgb(255, 0, 0);		// red head
+	Color snakeBody			= rgb(128, 128, 128);	// grey body
+	Color bait				= rgb(0, 255, 0);
+	Color uiText			= rgb(0, 0, 0);
+	Color scoreBackground	= rgb(127, 255, 127);
+	Color timeBackground	= rgb(127, 127, 127);
+	Color messageText		= rgb(0, 0, 0);
+	Color messageBackground	= rgb(127, 127, 127);
+	Color gameOverText		= rgb(255, 255, 255);
+	Color gameOverBackground = rgb(255, 0, 0);
+
+	CellPalette cellPalette() const {
+		CellPalette p;
+		p.fill[static_cast<int>(CellClass::Body)] = snakeBody;
+		p.fill[static_cast<int>(CellClass::Head)] = snakeHead;
+		p.fill[static_cast<int>(CellClass::Bait)] = bait;
+		p.outline = cellOutline;
+		return p;
+	}
+};
+
+struct SceneState {
+	bool isPaused = false;
+	int elapsedSec = 0; // shown as mm:ss in the UI bar
+	float tickAlpha = 0.0f; // how far into the next tick the frame is, 0 draws the tick as is (FixedStep::alpha)
+	const char* status = nullptr; // centred in the UI bar (e.g. the latency readout), nullptr for none
+};
+
+// what the render target currently shows, for drawDirty()
+struct SceneCache {
+	bool valid = false;
+	int score = 0;
+	int elapsedSec = 0;
+	bool isPaused = false;
+	char status[32] = "";
+	Cell motion[2];		// cells under the last drawMotion(), they need a redraw even without a tick
+	int nMotion = 0;
+
+	bool uiChanged(int score_, int elapsedSec_, const char* status_ = nullptr) const {
+		return !valid || score != score_ || elapsedSec != elapsedSec_ || strncmp(status, status_ ? status_ : "", sizeof(status) - 1) != 0;
+	}
+	void setUi(int score_, int elapsedSec_, const char* status_ = nullptr) {
+		valid = true;
+		score = score_;
+		elapsedSec = elapsedSec_;
+		snprintf(status, sizeof(status), "%s", status_ ? status_ : "");
+	}
+};
+
+class Scene {
+public:
+	// mm:ss, the colon blinks every other second; buff needs 8 chars
+	static void formatDuration(char* buff, size_t size, int elapsedSec);
+
+	// hands the overlay messages to Renderer::prepareText, once per renderer
+	static void prepareText(Renderer& r, const SceneStyle& s);
+
+	// does not clear, the caller decides (GDI erases through the window background)
+	static void drawGamePlay(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, const SceneState& st);
+	// same picture, but snake and bait go through `cells` and one Renderer::drawCells pass
+	static void drawGamePlay(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, const SceneState& st, CellLayer& cells);
+	static void drawGameOver(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, const SceneState& st);
+
+	// Incremental game play frame: redraws sim.dirty() cells and, if score or displayed time
+	// changed, the UI bar; falls back to a cleared full frame when `shown` is stale.
+	// The caller clears the sim's dirty cells afterwards.
+	static void drawDirty(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, const SceneState& st, SceneCache& shown);
+	// game play frame restricted to the cells / UI bar touching `region` (a WM_PAINT update rect)
+	static void drawRegion(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, const SceneState& st, const RectI& region);
+	// same for an update region given as its rectangles (GetRegionData), so cells invalidated
+	// far apart repaint on their own instead of the bounding box around them
+	static void drawRegion(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, const SceneState& st, const RectI* rects, int nRects);
+
+	static void drawLayout(Renderer& r, const SceneLayout& l, const SceneStyle& s);
+	static void drawGamePlayUi(Renderer& r, const SceneLayout& l, const SceneStyle& s, int score, int elapsedSec, const char* status = nullptr);
+	static void drawUiBar(Renderer& r, const SceneLayout& l, const SceneStyle& s, int score, int elapsedSec, const char* status = nullptr); // cleared, framed and filled in
+	static void drawCell(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, const Cell& c); // from scratch
+	static void drawSnake(Renderer& r, const SceneLayout& l, const SceneStyle& s, const Snake& snake);
+	static void drawBait(Renderer& r, const SceneLayout& l, const SceneStyle& s, const Bait& bait);
+	static void drawBoard(Renderer& r, const SceneLayout& l, const SceneStyle& s, const CellLayer& cells);
+	static void drawPause(Renderer& r, const SceneLayout& l, const SceneStyle& s);
+
+	// The snake `alpha` of the way into its next tick: the head reaches that far into the next
+	// cell and, unless the snake is growing, the tail has left as much of its cell. Goes over a
+	// frame of the current tick; motionCells() lists the (at most 2) cells it touches.
+	static void drawMotion(Renderer& r, const SceneLayout& l, const SceneStyle& s, const GameSim& sim, float alpha);
+	static int motionCells(const GameSim& sim, Cell out[2]);
+	// background plus the part of the board frame running through `rect`
+	static void drawEmpty(Renderer& r, const SceneLayout& l, const SceneStyle& s, const RectI& rect);
+
+	// filled square with an outline, like GDI Rectangle() with the default pen
+	static void drawSquare(Renderer& r, const RectI& rect, Color fill, Color outline) {
+		r.fillRect(rect, fill);
+		r.frameRect(rect, outline);
+	}
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+// Serpentine walk over a rectangle of the board: row 0 left to right, row 1 right to left, ...
+// Lays out long snakes that cannot die on the next few steps, for benchmarks and tests; the
+// origin lets a caller keep the walk off the edge cells.
+
+#include "GameSim.h"
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+struct SerpentinePath {
+	int width = 0;
+	int height = 0;
+	std::vector<Cell> cells; // visiting order
+
+	SerpentinePath(int width_, int height_) : SerpentinePath(0, 0, width_, height_) { }
+
+	// the width_ x height_ rectangle whose top left cell is (x0, y0)
+	SerpentinePath(int x0, int y0, int width_, int height_) : width(width_), height(height_) {
+		cells.reserve(static_cast<size_t>(width_) * static_cast<size_t>(height_));
+		for (int y = 0; y < height_; y++) {
+			for (int i = 0; i < width_; i++) {
+				int x = (y % 2 == 0) ? i : width_ - 1 - i;
+				cells.push_back(Cell{ x0 + x, y0 + y });
+			}
+		}
+	}
+
+	// smallest square board holding a snake of `length` with as many cells left to walk into
+	static int sideFor(size_t length) {
+		int side = static_cast<int>(std::ceil(std::sqrt(2.0 * static_cast<double>(length))));
+		return side < 4 ? 4 : side;
+	}
+
+	Action actionAt(size_t i) const {
+		Cell a = cells[i];
+		Cell b = cells[i + 1];
+		if (b.x > a.x) return Action::E;
+		if (b.x < a.x) return Action::W;
+		return b.y > a.y ? Action::S : Action::N;
+	}
+
+	// cells[0, length) head first, i.e. the head on cells[length - 1]
+	std::vector<Cell> body(size_t length) const {
+		return std::vector<Cell>(cells.rend() - static_cast<std::ptrdiff_t>(length), cells.rend());
+	}
+
+	// places a snake covering cells[0, length) with its head on cells[length - 1];
+	// returns the path index of the head
+	size_t layout(GameSim& sim, size_t length) const {
+		sim.setSnakeBody(body(length), static_cast<Direction>(actionAt(length - 1)));
+		return length - 1;
+	}
+};
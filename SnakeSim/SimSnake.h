@@ -0,0 +1,143 @@
+#pragma once
+
+#include "SimTypes.h"
+#include "Board.h"
+#include "RingBuffer.h"
+#include "Zobrist.h"
+#include <stdexcept>
+
+class Snake
+{
+	friend class GameSim;
+	RingBuffer<PackedCell> _body; // front is the head
+	size_t _init_body_size = 3;
+	size_t _pendingGrowth = 0; // segments still to unfold from the tail
+	Direction _currentDirection = Direction::N;
+	size_t _speed = kBaseSpeed; // ms per tick, shorter as the snake grows
+	bool _canSetDirection = true; // prevent setDirection more than 1 per update;
+	bool _hasCollided = false;
+	uint64_t _hash = 0; // Zobrist: body cells, head, direction, pending growth
+	uint64_t _headKey = 0; // Head key of the current head, XORed out on the next move
+
+	void init(const Cell& pos_) {
+		if (_init_body_size == 0) { throw std::invalid_argument("init_size must be > 0"); }
+		if (_body.capacity() == 0) { _body.reset(1); }
+		_body.pushFront(packCell(pos_));
+		grow(_init_body_size - 1);
+		rehash();
+	}
+
+	// from scratch, after the body was set up segment by segment
+	void rehash() {
+		_headKey = zobristKey(ZobristFeature::Head, getHead());
+		uint64_t h = _headKey
+			^ zobristKey(ZobristFeature::Direction, static_cast<uint64_t>(_currentDirection))
+			^ zobristKey(ZobristFeature::Growth, _pendingGrowth);
+		for (size_t i = 0; i < _body.size(); i++) h ^= zobristKey(ZobristFeature::Body, unpackCell(_body[i]));
+		_hash = h;
+	}
+
+	void clear_body() { _body.clear(); _pendingGrowth = 0; }
+
+	void updateSpeed() {
+		size_t grown = getSize() > _init_body_size ? getSize() - _init_body_size : 0;
+		size_t faster = grown * kSpeedUpPerSegment;
+		_speed = faster < kBaseSpeed - kMinSpeed ? kBaseSpeed - faster : kMinSpeed;
+	}
+
+public:
+	static constexpr size_t kBaseSpeed = 100;		// ms per tick at the initial size
+	static constexpr size_t kMinSpeed = 50;
+	static constexpr size_t kSpeedUpPerSegment = 2;
+
+	Snake(int x_ = 0, int y_ = 0) { init(Cell{ x_, y_ }); }
+	Snake(const Cell& pos_) : Snake(pos_.x, pos_.y) { }
+
+	Cell getHead() const	{ return unpackCell(_body.front()); }
+	Cell getTail() const	{ return unpackCell(_body.back());  }
+
+	// i = 0 is the head, i = nSegments() - 1 the tail; segments still pending from grow() are not listed.
+	Cell getSegment(size_t i) const { return unpackCell(_body[i]); }
+	size_t nSegments() const { return _body.size(); }
+
+	void reset(const Cell& pos_, Board& board_) {
+		// +1: the head is written before a collision is detected, even on a full board
+		_body.reset(static_cast<size_t>(board_.width()) * static_cast<size_t>(board_.height()) + 1);
+		clear_body();
+		_currentDirection = Direction::N;
+		init(pos_);
+		board_.occupy(pos_);
+		_canSetDirection = true;
+		_hasCollided = false;
+	}
+
+	size_t getSpeed() const { return _speed; } // tick interval the front end should run at, in ms
+	size_t getPendingGrowth() const { return _pendingGrowth; }
+	size_t getSize() const { return _body.size() + _pendingGrowth; };
+	uint64_t hash() const { return _hash; }
+
+	bool isOppositeDirection(Direction d) const { return oppositeDirection(d) == _currentDirection; }
+
+	void setDirection(Direction d) {
+		if (!_canSetDirection || isOppositeDirection(d)) return;
+		if (d != _currentDirection) {
+			_hash ^= zobristKey(ZobristFeature::Direction, static_cast<uint64_t>(_currentDirection)) ^ zobristKey(ZobristFeature::Direction, static_cast<uint64_t>(d));
+		}
+		_currentDirection = d;
+		_canSetDirection = false; // wait move() to release;
+	}
+
+	Direction getCurrentDirection() const { return _currentDirection; }
+	Cell getCurrentDirectionAsVector() const { return directionAsVector(_currentDirection); }
+
+	Cell getPos() const { return getHead(); }
+
+	Cell getNextPos() const {
+		Cell cd = getCurrentDirectionAsVector();
+		return Cell{ getHead().x + cd.x, getHead().y + cd.y };
+	}
+
+	// The tail leaves its cell before the head enters the next one, so chasing the tail is safe.
+	// Returns true when the head ran into a wall or into the body.
+	bool move(Board& board_) {
+		Cell next = getNextPos();
+		if (_pendingGrowth > 0) {
+			_hash ^= zobristKey(ZobristFeature::Growth, _pendingGrowth) ^ zobristKey(ZobristFeature::Growth, _pendingGrowth - 1);
+			_pendingGrowth--;
+		} else {
+			_hash ^= zobristKey(ZobristFeature::Body, getTail());
+			board_.vacate(getTail());
+			_body.popBack();
+		}
+
+		const uint64_t headKey = zobristKey(ZobristFeature::Head, next);
+		_hash ^= _headKey ^ headKey;
+		_headKey = headKey;
+		_body.pushFront(packCell(next));
+		_hasCollided = board_.occupy(next);
+		if (!_hasCollided) _hash ^= zobristKey(ZobristFeature::Body, next); // a cell already set stays set
+		_canSetDirection = true;
+		return _hasCollided;
+	}
+
+	void grow(const size_t n = 1) {
+		_hash ^= zobristKey(ZobristFeature::Growth, _pendingGrowth) ^ zobristKey(ZobristFeature::Growth, _pendingGrowth + n);
+		_pendingGrowth += n;
+		updateSpeed();
+	}
+
+	bool hasCollided() const { return _hasCollided; }
+
+	void onKeyUp()		{ setDirection(Direction::N); }
+	void onKeyRight()	{ setDirection(Direction::E); }
+	void onKeyDown()	{ setDirection(Direction::S); }
+	void onKeyLeft()	{ setDirection(Direction::W); }
+};
+
+class Bait {
+	Cell _pos{ 0, 0 };
+
+public:
+	const Cell& getPos() const { return _pos; }
+	void setPos(const Cell& pos_) { _pos = pos_; }
+};
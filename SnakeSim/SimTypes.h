@@ -0,0 +1,53 @@
+#pragma once
+
+// Platform independent value types shared by the simulation core and the front ends.
+// Positions are in board cells, (0, 0) is the top-left cell; pixels are a renderer concern.
+
+#include <cstdint>
+#include <cassert>
+
+enum class Direction { N = 0,  E,  S, W	 };
+
+// Action fed to GameSim::step(), None keeps the current direction.
+enum class Action { N = 0, E, S, W, None };
+
+struct Cell {
+	int x = 0;
+	int y = 0;
+
+	bool operator==(const Cell& o) const { return x == o.x && y == o.y; }
+	bool operator!=(const Cell& o) const { return !(*this == o); }
+};
+
+struct StepResult {
+	bool ate = false;
+	bool gameOver = false;
+	bool won = false; // board filled, gameOver is set too
+};
+
+inline Cell directionAsVector(Direction d) {
+	switch (d)
+	{
+		case Direction::N: { return Cell{  0, -1 }; } break;
+		case Direction::E: { return Cell{  1,  0 }; } break;
+		case Direction::S: { return Cell{  0,  1 }; } break;
+		case Direction::W: { return Cell{ -1,  0 }; } break;
+		default: { assert(false && "you should not be here"); } break;
+	}
+	return Cell{ 0, 0 };
+}
+
+inline Direction oppositeDirection(Direction d) {
+	return static_cast<Direction>((static_cast<int>(d) + 2) % 4);
+}
+
+// Cell packed into 32 bits (x low, y high, both signed 16 bit) for compact body storage.
+typedef uint32_t PackedCell;
+
+inline PackedCell packCell(const Cell& c) {
+	return (static_cast<uint32_t>(static_cast<uint16_t>(c.y)) << 16) | static_cast<uint16_t>(c.x);
+}
+
+inline Cell unpackCell(PackedCell p) {
+	return Cell{ static_cast<int16_t>(p & 0xFFFF), static_cast<int16_t>(p >> 16) };
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// Umbrella header of the headless simulation library.
+
+#include "SimTypes.h"
+#include "OccupancyGrid.h"
+#include "FreeCellSet.h"
+#include "Board.h"
+#include "RingBuffer.h"
+#include "Rng.h"
+#include "Zobrist.h"
+#include "DirtyCells.h"
+#include "SimSnake.h"
+#include "GameSim.h"
+#include "CompactSim.h"
+#include "SparseGrid.h"
+#include "LargeBoardSim.h"
+#include "ArenaSim.h"
+#include "FixedStep.h"
+#include "InputQueue.h"
+#include "LatencyStats.h"
+#include "BatchedSnakeEnv.h"
+#include "ParallelRunner.h"
+#include "Autopilot.h"
+#include "HamiltonCycle.h"
+#include "SerpentinePath.h"
+#include "MctsPlanner.h"
+#include "TranspositionTable.h"
+#include "Replay.h"
+#include "ReplayArchive.h"
+#include "RenderTypes.h"
+#include "CellLayer.h"
+#include "Renderer.h"
+#include "Framebuffer.h"
+#include "BitmapFont.h"
+#include "TextCache.h"
+#include "SpanFill.h"
+#include "SoftwareRenderer.h"
+#include "Scene.h"
+#include "DisplayList.h"
+#include "SpriteAtlas.h"
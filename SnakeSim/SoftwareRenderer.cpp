@@ -0,0 +1,127 @@
+#include "SoftwareRenderer.h"
+#include "BitmapFont.h"
+#include "SpanFill.h"
+#include <algorithm>
+#include <cstring>
+
+void SoftwareRenderer::fillSpan(uint8_t* row, int x0, int x1, Color c) {
+	if (x1 <= x0) return;
+	if (_fb.format == PixelFormat::Gray8) {
+		SpanFill::fill8(row + x0, static_cast<size_t>(x1 - x0), c.gray());
+		return;
+	}
+	SpanFill::fill32(row + static_cast<size_t>(x0) * 4, static_cast<size_t>(x1 - x0), c.rgba());
+}
+
+void SoftwareRenderer::clear(Color c) {
+	fillRect(_bounds, c);
+}
+
+void SoftwareRenderer::fillRect(const RectI& r, Color c) {
+	if (c.isTransparent()) return;
+	RectI cr = r.intersect(_bounds);
+	if (cr.isEmpty()) return;
+	for (int y = cr.top; y < cr.bottom; y++) {
+		fillSpan(_fb.row(y), cr.left, cr.right, c);
+	}
+}
+
+void SoftwareRenderer::frameRect(const RectI& r, Color c) {
+	if (r.isEmpty()) return;
+	fillRect(RectI{ r.left, r.top, r.right, r.top + 1 }, c);
+	fillRect(RectI{ r.left, r.bottom - 1, r.right, r.bottom }, c);
+	fillRect(RectI{ r.left, r.top + 1, r.left + 1, r.bottom - 1 }, c);
+	fillRect(RectI{ r.right - 1, r.top + 1, r.right, r.bottom - 1 }, c);
+}
+
+void SoftwareRenderer::drawRaster(const TextRaster& t, int x, int y, const RectI& clip, Color c) {
+	const TextRun* runs = _text.runs();
+	for (int gy = 0; gy < BitmapFont::kGlyphHeight; gy++) {
+		int y0 = y + gy * t.scale;
+		for (uint32_t i = t.rowBegin(gy); i < t.rowEnd[gy]; i++) {
+			fillRect(RectI{ x + runs[i].x0, y0, x + runs[i].x1, y0 + t.scale }.intersect(clip), c);
+		}
+	}
+}
+
+void SoftwareRenderer::drawText(const RectI& r, const char* s, const TextStyle& style) {
+	int scale = BitmapFont::scaleFor(style.size);
+	const TextRaster* prepared = _text.findPrepared(s, scale);
+	int w = prepared ? prepared->width : BitmapFont::textWidth(s, scale);
+	int h = BitmapFont::textHeight(scale);
+
+	int x = r.left;
+	if (style.align == TextAlign::Center) x = r.left + (r.width() - w) / 2;
+	else if (style.align == TextAlign::Right) x = r.right - w;
+	int y = r.top + (r.height() - h) / 2;
+
+	// clipped to r, like GDI DrawText without DT_NOCLIP
+	fillRect(RectI{ x, y, x + w, y + h }.intersect(r), style.background);
+	if (style.text.isTransparent()) return;
+	if (prepared) {
+		drawRaster(*prepared, x, y, r, style.text);
+		return;
+	}
+	for (const char* p = s; *p; p++, x += BitmapFont::kAdvance * scale) {
+		drawRaster(_text.glyph(*p, scale), x, y, r, style.text);
+	}
+}
+
+void SoftwareRenderer::prepareText(const char* s, const TextStyle& style) {
+	_text.prepare(s, BitmapFont::scaleFor(style.size));
+}
+
+void SoftwareRenderer::drawCells(const CellLayer& cells, int originX, int originY, int cellSize, const CellPalette& palette) {
+	if (cellSize <= 0 || cells.width() <= 0) return;
+	bool transparent = palette.outline.isTransparent();
+	for (int k = 1; k < static_cast<int>(CellClass::Count); k++) transparent |= palette.fill[k].isTransparent();
+	if (transparent) { // rare; the row templates assume every occupied pixel is written
+		Renderer::drawCells(cells, originX, originY, cellSize, palette);
+		return;
+	}
+
+	const int boardWidth = cells.width() * cellSize;
+	const int visX0 = std::max(originX, _bounds.left);
+	const int visX1 = std::min(originX + boardWidth, _bounds.right);
+	if (visX0 >= visX1) return;
+
+	const size_t bpp = static_cast<size_t>(Framebuffer::bytesPerPixel(_fb.format));
+	_edgeRow.resize(static_cast<size_t>(boardWidth) * bpp);
+	_innerRow.resize(static_cast<size_t>(boardWidth) * bpp);
+
+	for (int cy = 0; cy < cells.height(); cy++) {
+		const int y0 = originY + cy * cellSize;
+		const int rowY0 = std::max(y0, _bounds.top);
+		const int rowY1 = std::min(y0 + cellSize, _bounds.bottom);
+		if (rowY0 >= rowY1) continue;
+
+		// compose both templates for the occupied runs of this cell row
+		_runs.clear();
+		const uint8_t* src = cells.row(cy);
+		for (int cx = 0; cx < cells.width(); ) {
+			if (src[cx] == 0) { cx++; continue; }
+			int first = cx;
+			for (; cx < cells.width() && src[cx] != 0; cx++) {
+				int px = cx * cellSize;
+				fillSpan(_innerRow.data(), px, px + cellSize, palette.fill[src[cx]]);
+				fillSpan(_innerRow.data(), px, px + 1, palette.outline);
+				fillSpan(_innerRow.data(), px + cellSize - 1, px + cellSize, palette.outline);
+			}
+			Run run{ first * cellSize, cx * cellSize };
+			fillSpan(_edgeRow.data(), run.x0, run.x1, palette.outline);
+			_runs.push_back(run);
+		}
+
+		// and copy them down the cell, clipped to the target
+		for (int y = rowY0; y < rowY1; y++) {
+			const uint8_t* tmpl = (y == y0 || y == y0 + cellSize - 1) ? _edgeRow.data() : _innerRow.data();
+			uint8_t* dst = _fb.row(y);
+			for (const Run& run : _runs) {
+				int x0 = std::max(originX + run.x0, visX0);
+				int x1 = std::min(originX + run.x1, visX1);
+				if (x0 >= x1) continue;
+				std::memcpy(dst + static_cast<size_t>(x0) * bpp, tmpl + static_cast<size_t>(x0 - originX) * bpp, static_cast<size_t>(x1 - x0) * bpp);
+			}
+		}
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// Renderer that rasterizes into a Framebuffer on the CPU; text uses BitmapFont.
+
+#include "Framebuffer.h"
+#include "Renderer.h"
+#include "TextCache.h"
+#include <vector>
+
+class SoftwareRenderer : public Renderer {
+	Framebuffer _fb;
+	RectI _bounds;
+
+	// drawCells scratch: one cell row composed once as pixels, then copied down the cell
+	struct Run { int x0, x1; };	// occupied pixel columns, relative to the board
+	std::vector<uint8_t> _edgeRow;	// top and bottom pixel row of the cells: outline only
+	std::vector<uint8_t> _innerRow;	// the rows in between: outline, fill, outline
+	std::vector<Run> _runs;
+
+	TextCache _text;
+
+	void fillSpan(uint8_t* row, int x0, int x1, Color c);
+	void drawRaster(const TextRaster& t, int x, int y, const RectI& clip, Color c);
+
+public:
+	explicit SoftwareRenderer(const Framebuffer& fb_) { setTarget(fb_); }
+
+	void setTarget(const Framebuffer& fb_) {
+		_fb = fb_;
+		_bounds = RectI{ 0, 0, fb_.width, fb_.height };
+	}
+	const Framebuffer& target() const { return _fb; }
+
+	void clear(Color c) override;
+	void fillRect(const RectI& r, Color c) override;
+	void frameRect(const RectI& r, Color c) override;
+	void drawText(const RectI& r, const char* s, const TextStyle& style) override;
+	void prepareText(const char* s, const TextStyle& style) override;
+	void drawCells(const CellLayer& cells, int originX, int originY, int cellSize, const CellPalette& palette) override;
+};
@@ -0,0 +1,53 @@
+#include "SpanFill.h"
+#include <cstring>
+
+#if defined(SNAKESIM_SPAN_AVX2)
+#include <immintrin.h>
+#elif defined(SNAKESIM_SPAN_SSE2)
+#include <emmintrin.h>
+#endif
+
+const char* SpanFill::path() {
+#if defined(SNAKESIM_SPAN_AVX2)
+	return "avx2";
+#elif defined(SNAKESIM_SPAN_SSE2)
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
+
+void SpanFill::fill32(uint8_t* dst, size_t n, uint32_t v) {
+	size_t i = 0;
+#if defined(SNAKESIM_SPAN_AVX2)
+	__m256i v8 = _mm256_set1_epi32(static_cast<int>(v));
+	for (; i + 8 <= n; i += 8) _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), v8);
+	if (i + 4 <= n) {
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm256_castsi256_si128(v8));
+		i += 4;
+	}
+#elif defined(SNAKESIM_SPAN_SSE2)
+	__m128i v4 = _mm_set1_epi32(static_cast<int>(v));
+	for (; i + 8 <= n; i += 8) {
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), v4);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4 + 16), v4);
+	}
+	if (i + 4 <= n) {
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), v4);
+		i += 4;
+	}
+#endif
+	for (; i < n; i++) std::memcpy(dst + i * 4, &v, 4);
+}
+
+void SpanFill::fill8(uint8_t* dst, size_t n, uint8_t v) {
+	size_t i = 0;
+#if defined(SNAKESIM_SPAN_AVX2)
+	__m256i v32 = _mm256_set1_epi8(static_cast<char>(v));
+	for (; i + 32 <= n; i += 32) _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v32);
+#elif defined(SNAKESIM_SPAN_SSE2)
+	__m128i v16 = _mm_set1_epi8(static_cast<char>(v));
+	for (; i + 16 <= n; i += 16) _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v16);
+#endif
+	if (i < n) std::memset(dst + i, v, n - i);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+// Solid horizontal span fills used by the software renderer, with AVX2 / SSE2 paths
+// picked at compile time and a scalar fallback. Build with SNAKESIM_AVX2 (CMake option)
+// to get the AVX2 path; define SNAKESIM_NO_SIMD to force the scalar one.
+
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(SNAKESIM_NO_SIMD)
+#if defined(__AVX2__)
+#define SNAKESIM_SPAN_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SNAKESIM_SPAN_SSE2 1
+#endif
+#endif
+
+namespace SpanFill {
+	// "avx2", "sse2" or "scalar"
+	const char* path();
+
+	// n 4-byte pixels of v; dst needs no alignment
+	void fill32(uint8_t* dst, size_t n, uint32_t v);
+	// n 1-byte pixels of v
+	void fill8(uint8_t* dst, size_t n, uint8_t v);
+}
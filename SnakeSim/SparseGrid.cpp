@@ -0,0 +1,138 @@
+#include "SparseGrid.h"
+#include "BitOps.h"
+#include <algorithm>
+#include <cstring>
+
+void SparseGrid::reset(int width_, int height_) {
+	_width = width_;
+	_height = height_;
+	_count = 0;
+	_freeTiles.clear();
+	for (size_t i = _tiles.size(); i > 0; i--) _freeTiles.push_back(static_cast<uint32_t>(i - 1));
+	if (_keys.empty()) rehash(64);
+	else std::fill(_keys.begin(), _keys.end(), kEmptyKey);
+	_used = 0;
+}
+
+size_t SparseGrid::memoryBytes() const {
+	return _tiles.capacity() * sizeof(Tile) + _freeTiles.capacity() * sizeof(uint32_t)
+		+ _keys.capacity() * sizeof(uint64_t) + _index.capacity() * sizeof(uint32_t);
+}
+
+uint32_t SparseGrid::find(uint64_t key) const {
+	const size_t mask = _keys.size() - 1;
+	for (size_t i = hashOf(key) & mask;; i = (i + 1) & mask) {
+		if (_keys[i] == key) return _index[i];
+		if (_keys[i] == kEmptyKey) return kNone;
+	}
+}
+
+uint32_t SparseGrid::findOrAdd(uint64_t key) {
+	if ((_used + 1) * 4 > _keys.size() * 3) rehash(_keys.size() * 2); // load <= 3/4
+	const size_t mask = _keys.size() - 1;
+	size_t i = hashOf(key) & mask;
+	for (; _keys[i] != kEmptyKey; i = (i + 1) & mask) {
+		if (_keys[i] == key) return _index[i];
+	}
+
+	uint32_t t;
+	if (!_freeTiles.empty()) { t = _freeTiles.back(); _freeTiles.pop_back(); }
+	else { t = static_cast<uint32_t>(_tiles.size()); _tiles.emplace_back(); }
+	std::memset(&_tiles[t], 0, sizeof(Tile));
+	_keys[i] = key;
+	_index[i] = t;
+	_used++;
+	return t;
+}
+
+// backward-shift deletion: no tombstones, probes stay as short as the load factor says
+void SparseGrid::erase(uint64_t key) {
+	const size_t mask = _keys.size() - 1;
+	size_t i = hashOf(key) & mask;
+	while (_keys[i] != key) {
+		if (_keys[i] == kEmptyKey) return;
+		i = (i + 1) & mask;
+	}
+	_freeTiles.push_back(_index[i]);
+	_used--;
+
+	for (size_t j = (i + 1) & mask; _keys[j] != kEmptyKey; j = (j + 1) & mask) {
+		size_t home = hashOf(_keys[j]) & mask;
+		// move j into the hole at i unless its home lies cyclically in (i, j]
+		bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+		if (stays) continue;
+		_keys[i] = _keys[j];
+		_index[i] = _index[j];
+		i = j;
+	}
+	_keys[i] = kEmptyKey;
+}
+
+void SparseGrid::rehash(size_t capacity) {
+	std::vector<uint64_t> keys(capacity, kEmptyKey);
+	std::vector<uint32_t> index(capacity, kNone);
+	const size_t mask = capacity - 1;
+	for (size_t j = 0; j < _keys.size(); j++) {
+		if (_keys[j] == kEmptyKey) continue;
+		size_t i = hashOf(_keys[j]) & mask;
+		while (keys[i] != kEmptyKey) i = (i + 1) & mask;
+		keys[i] = _keys[j];
+		index[i] = _index[j];
+	}
+	_keys.swap(keys);
+	_index.swap(index);
+}
+
+bool SparseGrid::test(const Cell& c) const {
+	if (!isInside(c)) return true;
+	uint32_t t = find(tileKey(c));
+	if (t == kNone) return false;
+	return (_tiles[t].rows[c.y & (kTileSide - 1)] >> (c.x & (kTileSide - 1))) & 1;
+}
+
+bool SparseGrid::testAndSet(const Cell& c) {
+	if (!isInside(c)) return true;
+	Tile& tile = _tiles[findOrAdd(tileKey(c))];
+	uint64_t& row = tile.rows[c.y & (kTileSide - 1)];
+	uint64_t bit = uint64_t(1) << (c.x & (kTileSide - 1));
+	if (row & bit) return true;
+	row |= bit;
+	tile.count++;
+	_count++;
+	return false;
+}
+
+void SparseGrid::clear(const Cell& c) {
+	if (!isInside(c)) return;
+	uint64_t key = tileKey(c);
+	uint32_t t = find(key);
+	if (t == kNone) return;
+	Tile& tile = _tiles[t];
+	uint64_t& row = tile.rows[c.y & (kTileSide - 1)];
+	uint64_t bit = uint64_t(1) << (c.x & (kTileSide - 1));
+	if (!(row & bit)) return;
+	row &= ~bit;
+	_count--;
+	if (--tile.count == 0) erase(key);
+}
+
+Cell SparseGrid::nthFree(uint64_t k) const {
+	for (int ty = 0; ty < _height; ty += kTileSide) {
+		const int h = std::min(kTileSide, _height - ty);
+		for (int tx = 0; tx < _width; tx += kTileSide) {
+			const int w = std::min(kTileSide, _width - tx);
+			const uint32_t t = find(tileKey(Cell{ tx, ty }));
+			const uint64_t nFree = static_cast<uint64_t>(w) * static_cast<uint64_t>(h) - (t == kNone ? 0 : _tiles[t].count);
+			if (k >= nFree) { k -= nFree; continue; }
+
+			const uint64_t inBoard = w == kTileSide ? ~uint64_t(0) : (uint64_t(1) << w) - 1;
+			for (int y = 0; y < h; y++) {
+				uint64_t freeBits = ~(t == kNone ? 0 : _tiles[t].rows[y]) & inBoard;
+				uint64_t n = static_cast<uint64_t>(popcount64(freeBits));
+				if (k < n) return Cell{ tx + selectBit64(freeBits, static_cast<int>(k)), ty + y };
+				k -= n;
+			}
+		}
+	}
+	return Cell{ -1, -1 };
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+// Occupancy bits for boards far too large for OccupancyGrid (100k x 100k is 10^10 cells,
+// 1.25 GB of bits): the board is cut into 64 x 64 tiles and only tiles holding a segment
+// exist. A tile is 64 row words, found through an open-addressing table keyed by its tile
+// coordinates; it goes back to a free list once its last segment leaves. Memory follows the
+// snake length, not the board area; test / set / clear are one hash probe plus one bit.
+//
+// Same conventions as OccupancyGrid: cells off the board read as set (walls).
+
+#include "SimTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class SparseGrid {
+public:
+	static constexpr int kTileBits = 6;
+	static constexpr int kTileSide = 1 << kTileBits; // 64 x 64 cells per tile
+
+	SparseGrid() = default;
+	SparseGrid(int width_, int height_) { reset(width_, height_); }
+
+	// keeps the allocations, drops every tile
+	void reset(int width_, int height_);
+
+	bool isInside(const Cell& c) const { return c.x >= 0 && c.y >= 0 && c.x < _width && c.y < _height; }
+
+	bool test(const Cell& c) const;
+	// returns the previous state, i.e. whether c was a wall or a segment
+	bool testAndSet(const Cell& c);
+	void clear(const Cell& c);
+
+	// the k-th (0 based) free cell, k < width * height - count(), counting tile by tile in row
+	// order and row by row inside a tile; visits every tile position of the board, so it is
+	// for boards that are nearly full, i.e. small
+	Cell nthFree(uint64_t k) const;
+
+	uint64_t count()	const { return _count; }	// set cells on the board
+	size_t nTiles()		const { return _used; }		// tiles holding at least one set cell
+	size_t memoryBytes() const;						// tiles (used and pooled) plus the table
+	int width()  const { return _width; }
+	int height() const { return _height; }
+
+private:
+	struct Tile {
+		uint64_t rows[kTileSide];
+		uint32_t count;
+	};
+
+	static constexpr uint32_t kNone = 0xFFFFFFFFu;
+	static constexpr uint64_t kEmptyKey = 0; // keys are stored + 1
+
+	int _width = 0;
+	int _height = 0;
+	uint64_t _count = 0;
+
+	std::vector<Tile> _tiles;
+	std::vector<uint32_t> _freeTiles;
+	std::vector<uint64_t> _keys;	// open addressing, linear probing, power of two size
+	std::vector<uint32_t> _index;	// _keys[i] -> _tiles index
+	size_t _used = 0;
+
+	static uint64_t tileKey(const Cell& c) {
+		return ((static_cast<uint64_t>(static_cast<uint32_t>(c.y >> kTileBits)) << 32) | static_cast<uint32_t>(c.x >> kTileBits)) + 1;
+	}
+	static size_t hashOf(uint64_t key) { // splitmix64 finaliser
+		key ^= key >> 30; key *= 0xbf58476d1ce4e5b9ull;
+		key ^= key >> 27; key *= 0x94d049bb133111ebull;
+		return static_cast<size_t>(key ^ (key >> 31));
+	}
+
+	uint32_t find(uint64_t key) const;
+	uint32_t findOrAdd(uint64_t key);
+	void erase(uint64_t key);
+	void rehash(size_t capacity);
+};
@@ -0,0 +1,251 @@
+#include "SpriteAtlas.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+	const char kMagic[4] = { 'S', 'N', 'K', 'T' };
+	const size_t kHeaderSize = 4 + 2 * 5;
+
+	enum OpKind : uint8_t { kKeep = 0, kRun = 1, kLiteral = 2 };
+
+	uint16_t getU16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+	uint32_t getU32(const uint8_t* p) { return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24); }
+
+	void putU16(std::vector<uint8_t>& out, uint32_t v) {
+		out.push_back(static_cast<uint8_t>(v));
+		out.push_back(static_cast<uint8_t>(v >> 8));
+	}
+	void putU32(std::vector<uint8_t>& out, size_t at, uint32_t v) {
+		for (int i = 0; i < 4; i++) out[at + i] = static_cast<uint8_t>(v >> (8 * i));
+	}
+
+	void putOp(std::vector<uint8_t>& out, OpKind kind, size_t count) {
+		if (count <= 63) {
+			out.push_back(static_cast<uint8_t>((kind << 6) | (count - 1)));
+			return;
+		}
+		out.push_back(static_cast<uint8_t>((kind << 6) | 63));
+		size_t v = count - 64;
+		while (v >= 0x80) {
+			out.push_back(static_cast<uint8_t>(v | 0x80));
+			v >>= 7;
+		}
+		out.push_back(static_cast<uint8_t>(v));
+	}
+
+	bool getOp(const uint8_t* p, size_t size, size_t& pos, OpKind& kind, size_t& count) {
+		if (pos >= size) return false;
+		uint8_t b = p[pos++];
+		kind = static_cast<OpKind>(b >> 6);
+		count = (b & 63) + 1;
+		if (count < 64) return true;
+		size_t v = 0;
+		for (int shift = 0; shift < 32; shift += 7) {
+			if (pos >= size) return false;
+			uint8_t c = p[pos++];
+			v |= static_cast<size_t>(c & 0x7F) << shift;
+			if (!(c & 0x80)) {
+				count = 64 + v;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// greedy: keep runs against the previous frame, then repeats of 3+, else literals
+	void encodeFrame(const std::vector<uint8_t>& cur, const std::vector<uint8_t>* prev, std::vector<uint8_t>& out) {
+		const size_t n = cur.size();
+		auto keeps = [&](size_t i) { return prev && i < n && cur[i] == (*prev)[i]; };
+		auto repeats = [&](size_t i) { return i + 2 < n && cur[i] == cur[i + 1] && cur[i] == cur[i + 2]; };
+
+		size_t i = 0;
+		while (i < n) {
+			if (keeps(i)) {
+				size_t j = i;
+				while (keeps(j)) j++;
+				putOp(out, kKeep, j - i);
+				i = j;
+			}
+			else if (repeats(i)) {
+				size_t j = i;
+				while (j < n && cur[j] == cur[i]) j++;
+				putOp(out, kRun, j - i);
+				out.push_back(cur[i]);
+				i = j;
+			}
+			else {
+				size_t j = i + 1;
+				while (j < n && !(keeps(j) && keeps(j + 1)) && !repeats(j)) j++;
+				putOp(out, kLiteral, j - i);
+				out.insert(out.end(), cur.begin() + static_cast<std::ptrdiff_t>(i), cur.begin() + static_cast<std::ptrdiff_t>(j));
+				i = j;
+			}
+		}
+	}
+}
+
+bool SpriteImage::loadBmp(const std::string& path, SpriteImage& out) {
+	std::ifstream f(path, std::ios::binary);
+	if (!f) return false;
+	std::vector<uint8_t> d((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+	if (d.size() < 54 || d[0] != 'B' || d[1] != 'M') return false;
+
+	uint32_t dataOffset = getU32(&d[10]);
+	int32_t w = static_cast<int32_t>(getU32(&d[18]));
+	int32_t h = static_cast<int32_t>(getU32(&d[22]));
+	uint16_t bpp = getU16(&d[28]);
+	uint32_t compression = getU32(&d[30]);
+	if (bpp != 24 || compression != 0 || w <= 0 || h == 0) return false;
+
+	bool bottomUp = h > 0;
+	int height = bottomUp ? h : -h;
+	size_t stride = (static_cast<size_t>(w) * 3 + 3) & ~size_t(3);
+	if (dataOffset + stride * static_cast<size_t>(height) > d.size()) return false;
+
+	out.width = w;
+	out.height = height;
+	out.bgr.resize(static_cast<size_t>(w) * 3 * static_cast<size_t>(height));
+	for (int y = 0; y < height; y++) {
+		int src = bottomUp ? height - 1 - y : y;
+		std::memcpy(&out.bgr[static_cast<size_t>(y) * w * 3], &d[dataOffset + static_cast<size_t>(src) * stride], static_cast<size_t>(w) * 3);
+	}
+	return true;
+}
+
+bool SpriteAtlas::encode(const std::vector<SpriteImage>& frames, std::vector<uint8_t>& out) {
+	if (frames.empty() || frames.size() > 0xFFFF) return false;
+	const int w = frames[0].width;
+	const int h = frames[0].height;
+	if (w <= 0 || h <= 0 || w > 0xFFFF || h > 0xFFFF) return false;
+
+	// shared palette, in order of first use
+	std::vector<uint32_t> palette;
+	std::vector<std::vector<uint8_t>> indexed(frames.size());
+	for (size_t f = 0; f < frames.size(); f++) {
+		const SpriteImage& img = frames[f];
+		if (img.width != w || img.height != h) return false;
+		indexed[f].resize(static_cast<size_t>(w) * static_cast<size_t>(h));
+		for (size_t p = 0; p < indexed[f].size(); p++) {
+			uint32_t c = static_cast<uint32_t>(img.bgr[p * 3]) | (static_cast<uint32_t>(img.bgr[p * 3 + 1]) << 8) | (static_cast<uint32_t>(img.bgr[p * 3 + 2]) << 16);
+			auto it = std::find(palette.begin(), palette.end(), c);
+			if (it == palette.end()) {
+				if (palette.size() == 256) return false;
+				it = palette.insert(palette.end(), c);
+			}
+			indexed[f][p] = static_cast<uint8_t>(it - palette.begin());
+		}
+	}
+
+	out.clear();
+	for (char c : kMagic) out.push_back(static_cast<uint8_t>(c));
+	putU16(out, kVersion);
+	putU16(out, static_cast<uint32_t>(w));
+	putU16(out, static_cast<uint32_t>(h));
+	putU16(out, static_cast<uint32_t>(frames.size()));
+	putU16(out, static_cast<uint32_t>(palette.size()));
+	for (uint32_t c : palette) {
+		out.push_back(static_cast<uint8_t>(c));
+		out.push_back(static_cast<uint8_t>(c >> 8));
+		out.push_back(static_cast<uint8_t>(c >> 16));
+		out.push_back(0);
+	}
+	size_t table = out.size();
+	out.resize(table + frames.size() * 8);
+	for (size_t f = 0; f < frames.size(); f++) {
+		size_t begin = out.size();
+		encodeFrame(indexed[f], f > 0 ? &indexed[f - 1] : nullptr, out);
+		putU32(out, table + f * 8, static_cast<uint32_t>(begin));
+		putU32(out, table + f * 8 + 4, static_cast<uint32_t>(out.size() - begin));
+	}
+	return true;
+}
+
+bool SpriteAtlas::open(const uint8_t* data, size_t size) {
+	_data = nullptr;
+	_frames.clear();
+	_decoded = 0;
+	if (!data || size < kHeaderSize || std::memcmp(data, kMagic, 4) != 0 || getU16(data + 4) != kVersion) return false;
+
+	int w = getU16(data + 6);
+	int h = getU16(data + 8);
+	int count = getU16(data + 10);
+	int paletteSize = getU16(data + 12);
+	if (w == 0 || h == 0 || count == 0 || paletteSize == 0 || paletteSize > 256) return false;
+
+	size_t table = kHeaderSize + static_cast<size_t>(paletteSize) * 4;
+	if (table + static_cast<size_t>(count) * 8 > size) return false;
+	_frames.resize(static_cast<size_t>(count));
+	for (int i = 0; i < count; i++) {
+		FrameRef& f = _frames[static_cast<size_t>(i)];
+		f.offset = getU32(data + table + static_cast<size_t>(i) * 8);
+		f.size = getU32(data + table + static_cast<size_t>(i) * 8 + 4);
+		if (static_cast<size_t>(f.offset) + f.size > size) { _frames.clear(); return false; }
+	}
+
+	_data = data;
+	_size = size;
+	_width = w;
+	_height = h;
+	_count = count;
+	_paletteSize = paletteSize;
+	_palette = data + kHeaderSize;
+	return true;
+}
+
+void SpriteAtlas::setSurface(uint8_t* pixels, size_t stride) {
+	_surface = pixels;
+	_stride = stride;
+	_decoded = 0;
+}
+
+bool SpriteAtlas::decodeUpTo(int i) {
+	if (!_data || !_surface || i >= _count) return false;
+	while (_decoded <= i) {
+		if (!decodeFrame(_decoded)) return false;
+		_decoded++;
+	}
+	return true;
+}
+
+bool SpriteAtlas::decodeFrame(int i) {
+	const FrameRef& f = _frames[static_cast<size_t>(i)];
+	const uint8_t* p = _data + f.offset;
+	const size_t total = static_cast<size_t>(_width) * static_cast<size_t>(_height);
+
+	size_t pos = 0;
+	size_t pixel = 0;
+	while (pixel < total) {
+		OpKind kind;
+		size_t count;
+		if (!getOp(p, f.size, pos, kind, count) || count > total - pixel) return false;
+		if (kind == kRun && pos >= f.size) return false;
+		if (kind == kLiteral && count > f.size - pos) return false;
+		if (kind > kLiteral) return false;
+
+		// ops may cross rows; apply them one row segment at a time
+		while (count > 0) {
+			int y = static_cast<int>(pixel / static_cast<size_t>(_width));
+			int x = static_cast<int>(pixel % static_cast<size_t>(_width));
+			size_t k = std::min(count, static_cast<size_t>(_width - x));
+			uint8_t* dst = _surface + static_cast<size_t>(frameTop(i) + y) * _stride + x;
+			switch (kind) {
+				case kKeep: {
+					if (i == 0) std::memset(dst, 0, k);
+					else std::memcpy(dst, dst - static_cast<size_t>(_height) * _stride, k);
+				} break;
+				case kRun: {
+					std::memset(dst, p[pos], k);
+				} break;
+				case kLiteral: {
+					std::memcpy(dst, p + pos, k);
+					pos += k;
+				} break;
+			}
+			pixel += k;
+			count -= k;
+		}
+		if (kind == kRun) pos++;
+	}
+	return pos == f.size;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+// Packed animation frames, e.g. the landing screen snake: one palette of at most 256
+// colours and each frame stored as an op stream against the previous one, so the 13
+// title frames fit in a few KB instead of 2.5 MB of 24-bit BMPs. Frames are decoded
+// lazily, in order, into one caller-owned 8-bit surface that holds all of them stacked
+// vertically, and drawn as sub-rects of it.
+//
+// Layout (little endian):
+//   "SNKT" | version u16 | frameWidth, frameHeight, frameCount, paletteSize u16
+//   | palette: paletteSize x (b, g, r, 0), i.e. a DIB colour table
+//   | frameCount x (offset u32, size u32), offsets from the start of the data
+//   | frame streams
+// Frame stream, over the frame's palette indices in top-down row order:
+//   op byte: kind (2 high bits) | count - 1 (6 low bits; 63 means 64 + varint that follows)
+//   kind 0: keep the previous frame's pixels (0 for the first frame)
+//   kind 1: one index byte follows, repeated count times
+//   kind 2: count index bytes follow
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 24-bit image, top-down rows of b, g, r
+struct SpriteImage {
+	int width = 0;
+	int height = 0;
+	std::vector<uint8_t> bgr;
+
+	// uncompressed 24-bit BMPs only, which is what the title frames are
+	static bool loadBmp(const std::string& path, SpriteImage& out);
+};
+
+class SpriteAtlas {
+public:
+	static constexpr uint16_t kVersion = 1;
+
+	// frames must share one size and use at most 256 colours in total
+	static bool encode(const std::vector<SpriteImage>& frames, std::vector<uint8_t>& out);
+
+private:
+	struct FrameRef {
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	const uint8_t* _data = nullptr;
+	size_t _size = 0;
+	int _width = 0;
+	int _height = 0;
+	int _count = 0;
+	int _paletteSize = 0;
+	const uint8_t* _palette = nullptr;
+	std::vector<FrameRef> _frames;
+
+	uint8_t* _surface = nullptr;
+	size_t _stride = 0;
+	int _decoded = 0; // frames [0, _decoded) are in the surface
+
+	bool decodeFrame(int i);
+
+public:
+	// a view: data must outlive the atlas (a mapped file or a locked resource)
+	bool open(const uint8_t* data, size_t size);
+
+	// 8-bit surface of frameWidth x frameHeight * frameCount pixels, rows `stride` bytes apart
+	void setSurface(uint8_t* pixels, size_t stride);
+	static size_t surfaceStride(int width) { return (static_cast<size_t>(width) + 3) & ~size_t(3); } // DIB rows are 4-byte aligned
+
+	// decodes every frame up to i that is not in the surface yet; false on a corrupt stream
+	bool decodeUpTo(int i);
+	bool isDecoded(int i) const { return i < _decoded; }
+	int frameTop(int i) const { return i * _height; } // first surface row of frame i
+
+	int frameWidth()  const { return _width; }
+	int frameHeight() const { return _height; }
+	int frameCount()  const { return _count; }
+	int paletteSize() const { return _paletteSize; }
+	const uint8_t* palette() const { return _palette; } // paletteSize x (b, g, r, 0)
+	size_t encodedSize() const { return _size; }
+};
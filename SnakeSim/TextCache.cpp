@@ -0,0 +1,69 @@
+#include "TextCache.h"
+#include <cstring>
+
+uint64_t TextCache::hash(const char* s) {
+	uint64_t h = 14695981039346656037ULL; // FNV-1a
+	for (; *s; s++) {
+		h ^= static_cast<unsigned char>(*s);
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+TextRaster TextCache::rasterize(const char* s, int scale) {
+	TextRaster t;
+	t.width = BitmapFont::textWidth(s, scale);
+	t.scale = scale;
+	t.firstRun = static_cast<uint32_t>(_runs.size());
+	for (int gy = 0; gy < BitmapFont::kGlyphHeight; gy++) {
+		uint32_t rowFirst = static_cast<uint32_t>(_runs.size());
+		int x = 0;
+		for (const char* p = s; *p; p++, x += BitmapFont::kAdvance * scale) {
+			uint8_t bits = BitmapFont::glyph(*p)[gy];
+			for (int gx = 0; gx < BitmapFont::kGlyphWidth; gx++) {
+				if (!(bits & (0x10 >> gx))) continue;
+				int px = x + gx * scale;
+				if (_runs.size() > rowFirst && _runs.back().x1 == px) _runs.back().x1 = px + scale;
+				else _runs.push_back(TextRun{ px, px + scale });
+			}
+		}
+		t.rowEnd[gy] = static_cast<uint32_t>(_runs.size());
+	}
+	return t;
+}
+
+const TextRaster& TextCache::glyph(char c, int scale) {
+	unsigned char u = static_cast<unsigned char>(c);
+	if (u < 32 || u > 126) u = '?';
+
+	size_t set = 0;
+	while (set < _scales.size() && _scales[set] != scale) set++;
+	if (set == _scales.size()) {
+		_scales.push_back(scale);
+		char s[2] = { 0, 0 };
+		for (int i = 0; i < kGlyphCount; i++) {
+			s[0] = static_cast<char>(32 + i);
+			_glyphs.push_back(rasterize(s, scale));
+		}
+	}
+	return _glyphs[set * kGlyphCount + (u - 32)];
+}
+
+void TextCache::prepare(const char* s, int scale) {
+	if (findPrepared(s, scale)) return;
+	Prepared p;
+	p.hash = hash(s);
+	p.text = static_cast<uint32_t>(_chars.size());
+	p.raster = rasterize(s, scale);
+	_chars.insert(_chars.end(), s, s + std::strlen(s) + 1);
+	_prepared.push_back(p);
+}
+
+const TextRaster* TextCache::findPrepared(const char* s, int scale) const {
+	if (_prepared.empty()) return nullptr;
+	uint64_t h = hash(s);
+	for (const Prepared& p : _prepared) {
+		if (p.hash == h && p.raster.scale == scale && std::strcmp(_chars.data() + p.text, s) == 0) return &p.raster;
+	}
+	return nullptr;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+// Pre-rasterized BitmapFont text for the software renderer: the glyph set of each scale
+// (the font size key), built on first use, and whole static strings such as the overlay
+// messages, prepared once. Both are stored as runs of set pixels per font row, so
+// drawing is a few span fills and looking text up never allocates.
+
+#include "BitmapFont.h"
+#include <cstdint>
+#include <vector>
+
+struct TextRun {
+	int x0, x1;	// pixel columns [x0, x1) from the text origin
+};
+
+// runs of font row r are runs[rowEnd[r - 1], rowEnd[r]), row -1 starting at firstRun;
+// each font row is `scale` pixel rows high
+struct TextRaster {
+	int width = 0;
+	int scale = 1;
+	uint32_t firstRun = 0;
+	uint32_t rowEnd[BitmapFont::kGlyphHeight] = {};
+
+	uint32_t rowBegin(int r) const { return r == 0 ? firstRun : rowEnd[r - 1]; }
+};
+
+class TextCache {
+	static constexpr int kGlyphCount = 95; // printable ASCII
+
+	struct Prepared {
+		uint64_t hash;
+		uint32_t text;	// offset into _chars
+		TextRaster raster;
+	};
+
+	std::vector<TextRun> _runs;
+	std::vector<int> _scales;			// glyph sets built so far
+	std::vector<TextRaster> _glyphs;	// kGlyphCount per entry of _scales
+	std::vector<Prepared> _prepared;
+	std::vector<char> _chars;
+
+	TextRaster rasterize(const char* s, int scale);
+	static uint64_t hash(const char* s);
+
+public:
+	// rasterizes the whole glyph set the first time a scale is seen
+	const TextRaster& glyph(char c, int scale);
+
+	// s is copied; preparing the same string and scale twice is a no-op
+	void prepare(const char* s, int scale);
+	const TextRaster* findPrepared(const char* s, int scale) const;
+
+	const TextRun* runs() const { return _runs.data(); }
+};
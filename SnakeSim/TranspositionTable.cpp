@@ -0,0 +1,68 @@
+#include "TranspositionTable.h"
+#include <cstring>
+#include <stdexcept>
+
+TranspositionTable::TranspositionTable(size_t nEntries) {
+	if (nEntries == 0) { throw std::invalid_argument("table needs at least one entry"); }
+	size_t nBuckets = 1;
+	while (nBuckets * kWays < nEntries) nBuckets <<= 1;
+	_mask = nBuckets - 1;
+	_buckets.reset(new Bucket[nBuckets]);
+	clear();
+}
+
+void TranspositionTable::clear() {
+	for (size_t b = 0; b <= _mask; b++) {
+		for (size_t w = 0; w < kWays; w++) {
+			_buckets[b].check[w].store(0, std::memory_order_relaxed);
+			_buckets[b].data[w].store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+uint64_t TranspositionTable::pack(const TTEntry& e) {
+	uint32_t v;
+	std::memcpy(&v, &e.value, sizeof(v));
+	return kUsed | (static_cast<uint64_t>(e.flags & 0x7F) << 56) | (static_cast<uint64_t>(e.move) << 48)
+		| (static_cast<uint64_t>(e.depth) << 32) | v;
+}
+
+TTEntry TranspositionTable::unpack(uint64_t d) {
+	TTEntry e;
+	uint32_t v = static_cast<uint32_t>(d);
+	std::memcpy(&e.value, &v, sizeof(v));
+	e.depth = static_cast<uint16_t>(d >> 32);
+	e.move = static_cast<uint8_t>(d >> 48);
+	e.flags = static_cast<uint8_t>((d >> 56) & 0x7F);
+	return e;
+}
+
+// buckets by the low bits; the full hash is checked per entry
+bool TranspositionTable::probe(uint64_t hash, TTEntry& out) const {
+	const Bucket& b = _buckets[hash & _mask];
+	for (size_t w = 0; w < kWays; w++) {
+		uint64_t d = b.data[w].load(std::memory_order_relaxed);
+		uint64_t c = b.check[w].load(std::memory_order_relaxed);
+		if ((d & kUsed) && (c ^ d) == hash) {
+			out = unpack(d);
+			return true;
+		}
+	}
+	return false;
+}
+
+void TranspositionTable::store(uint64_t hash, const TTEntry& e) {
+	Bucket& b = _buckets[hash & _mask];
+	size_t victim = 0;
+	int victimDepth = 0x10000;
+	for (size_t w = 0; w < kWays; w++) {
+		uint64_t d = b.data[w].load(std::memory_order_relaxed);
+		uint64_t c = b.check[w].load(std::memory_order_relaxed);
+		if (!(d & kUsed) || (c ^ d) == hash) { victim = w; break; } // empty or the same state
+		int depth = static_cast<int>((d >> 32) & 0xFFFF);
+		if (depth < victimDepth) { victimDepth = depth; victim = w; }
+	}
+	uint64_t d = pack(e);
+	b.data[victim].store(d, std::memory_order_relaxed);
+	b.check[victim].store(hash ^ d, std::memory_order_relaxed);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+// Fixed-size table from a Zobrist hash (GameSim::hash()) to a search result, shared by any
+// number of search threads without locks. Each entry is two 64 bit atomics, hash ^ data and
+// data (lockless hashing, Hyatt & Mann): a reader that catches an entry half written sees
+// a hash that does not match and takes it as a miss, never as another state's result.
+// kWays entries share a cache-line bucket; store() overwrites the entry of the same state,
+// else the one searched least deep.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+struct TTEntry {
+	float value = 0.0f;
+	uint16_t depth = 0;		// how deep (or how many visits) the value was searched
+	uint8_t move = 0;		// best Action found
+	uint8_t flags = 0;		// caller defined, 7 bits
+};
+
+class TranspositionTable {
+public:
+	static constexpr size_t kWays = 4;
+
+	// room for at least nEntries, rounded up to a power of two of buckets
+	explicit TranspositionTable(size_t nEntries);
+
+	bool probe(uint64_t hash, TTEntry& out) const;
+	void store(uint64_t hash, const TTEntry& e);
+	void clear(); // not while other threads probe or store
+
+	size_t capacity() const { return (_mask + 1) * kWays; }
+	size_t memoryBytes() const { return (_mask + 1) * sizeof(Bucket); }
+
+private:
+	static constexpr uint64_t kUsed = uint64_t(1) << 63;
+
+	struct alignas(64) Bucket {
+		std::atomic<uint64_t> check[kWays];	// hash ^ data
+		std::atomic<uint64_t> data[kWays];
+	};
+
+	std::unique_ptr<Bucket[]> _buckets;
+	size_t _mask = 0;
+
+	static uint64_t pack(const TTEntry& e);
+	static TTEntry unpack(uint64_t d);
+};
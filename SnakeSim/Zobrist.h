@@ -0,0 +1,22 @@
+#pragma once
+
+// Zobrist keys for game states: one pseudo-random 64 bit key per (feature, value), a state's
+// hash is the XOR of the keys of what it has, so a move updates it with a few XORs.
+// GameSim::hash() covers the body cells, the head, the direction, the growth still to unfold
+// and the bait; the order of the body along the cells is not part of it.
+//
+// Keys are derived by hashing (feature, value) instead of drawn into tables, so they cost no
+// memory on any board size and are the same in every process, fit for dedup across runs.
+
+#include "SimTypes.h"
+#include "Rng.h"
+#include <cstdint>
+
+enum class ZobristFeature : uint64_t { Body = 1, Head, Direction, Growth, Bait };
+
+inline uint64_t zobristKey(ZobristFeature f, uint64_t value) {
+	uint64_t s = (static_cast<uint64_t>(f) << 56) ^ value;
+	return Rng::splitmix64(s);
+}
+
+inline uint64_t zobristKey(ZobristFeature f, const Cell& c) { return zobristKey(f, packCell(c)); }
@@ -0,0 +1,159 @@
+#include "ArenaSim.h"
+#include "TestUtil.h"
+#include <stdexcept>
+#include <vector>
+
+// The ownership grid rebuilt from the snakes and the bait slots must be the grid: every
+// body cell owned by its snake, every bait by its slot, nothing else owned, dead snakes
+// without segments.
+static bool gridMatches(const ArenaSim& arena) {
+	std::vector<uint32_t> expected(static_cast<size_t>(arena.width()) * static_cast<size_t>(arena.height()), ArenaSim::kFree);
+	auto at = [&](const Cell& c) -> uint32_t& { return expected[static_cast<size_t>(c.y) * static_cast<size_t>(arena.width()) + static_cast<size_t>(c.x)]; };
+	size_t nAlive = 0;
+	for (size_t i = 0; i < arena.nSnakes(); i++) {
+		if (!arena.isAlive(i)) {
+			if (arena.nSegments(i) != 0) return false;
+			continue;
+		}
+		nAlive++;
+		for (size_t k = 0; k < arena.nSegments(i); k++) {
+			const Cell c = arena.getSegment(i, k);
+			if (!arena.isInside(c) || at(c) != ArenaSim::kFree) return false;
+			at(c) = static_cast<uint32_t>(i) + 1;
+		}
+	}
+	for (size_t b = 0; b < arena.nBaitSlots(); b++) {
+		if (!arena.hasBait(b)) continue;
+		const Cell c = arena.getBait(b);
+		if (!arena.isInside(c) || at(c) != ArenaSim::kFree) return false;
+		at(c) = ArenaSim::kBaitBit | static_cast<uint32_t>(b);
+	}
+	if (nAlive != arena.nAlive()) return false;
+	for (int y = 0; y < arena.height(); y++) {
+		for (int x = 0; x < arena.width(); x++) {
+			if (arena.owner(Cell{ x, y }) != at(Cell{ x, y })) return false;
+		}
+	}
+	return true;
+}
+
+// crowded arenas with random turns: plenty of wall, body and head-on deaths, meals and
+// respawns, the grid checked after every tick
+static void gridMatchesSnakesAndBaits() {
+	uint32_t headOn = 0;
+	for (uint64_t seed = 1; seed <= 12; seed++) {
+		ArenaConfig config;
+		config.width = 12 + static_cast<int>(seed % 5);
+		config.height = 10 + static_cast<int>(seed % 3);
+		config.nSnakes = 10;
+		config.nBaits = 12;
+		config.respawn = seed % 3 != 0;
+		config.seed = seed;
+		ArenaSim arena(config);
+		CHECK(gridMatches(arena));
+
+		Rng rng(seed * 11);
+		std::vector<Action> actions(arena.nSnakes());
+		for (int t = 0; t < 400; t++) {
+			for (Action& a : actions) a = rng.below(3) == 0 ? static_cast<Action>(rng.below(5)) : Action::None;
+			arena.step(actions.data());
+			headOn += arena.lastTick().diedHeadOn;
+			const bool same = gridMatches(arena);
+			CHECK(same);
+			if (!same) break; // one report per arena
+		}
+	}
+	CHECK(headOn > 0);
+}
+
+static ArenaSim scene(uint32_t nSnakes) {
+	ArenaConfig config;
+	config.width = 8;
+	config.height = 8;
+	config.nSnakes = nSnakes;
+	config.nBaits = 0;
+	config.respawn = false;
+	ArenaSim arena(config);
+	for (uint32_t i = 0; i < nSnakes; i++) arena.setSnake(i, { Cell{ static_cast<int>(i), 7 } }, Direction::N);
+	return arena;
+}
+
+static void stepAll(ArenaSim& arena) {
+	std::vector<Action> none(arena.nSnakes(), Action::None);
+	arena.step(none.data());
+}
+
+// two heads entering the same cell on one tick: both die, by either id order
+static void headOnIntoSameCell() {
+	for (int first = 0; first < 2; first++) {
+		ArenaSim arena = scene(2);
+		arena.setSnake(static_cast<size_t>(first), { { 2, 3 }, { 1, 3 }, { 0, 3 } }, Direction::E);
+		arena.setSnake(static_cast<size_t>(1 - first), { { 4, 3 }, { 5, 3 }, { 6, 3 } }, Direction::W);
+		stepAll(arena);
+		CHECK_EQ(arena.lastTick().diedHeadOn, 2u);
+		CHECK(!arena.isAlive(0));
+		CHECK(!arena.isAlive(1));
+		CHECK_EQ(arena.nAlive(), 0u);
+		CHECK(gridMatches(arena));
+		CHECK_EQ(arena.owner(Cell{ 3, 3 }), ArenaSim::kFree);
+	}
+}
+
+// heads moving onto each other's head cell: each runs into the other's body, both die
+static void swappingHeads() {
+	ArenaSim arena = scene(2);
+	arena.setSnake(0, { { 2, 3 }, { 1, 3 } }, Direction::E);
+	arena.setSnake(1, { { 3, 3 }, { 4, 3 } }, Direction::W);
+	stepAll(arena);
+	CHECK_EQ(arena.lastTick().diedBody, 2u);
+	CHECK_EQ(arena.lastTick().diedHeadOn, 0u);
+	CHECK_EQ(arena.nAlive(), 0u);
+	CHECK(gridMatches(arena));
+}
+
+// a head may enter the cell another snake's tail leaves on the same tick, whichever moves first
+static void followingAnotherTail() {
+	for (int leader = 0; leader < 2; leader++) {
+		ArenaSim arena = scene(2);
+		const size_t follower = static_cast<size_t>(1 - leader);
+		arena.setSnake(static_cast<size_t>(leader), { { 3, 3 }, { 2, 3 }, { 1, 3 } }, Direction::E);
+		arena.setSnake(follower, { { 1, 4 }, { 1, 5 } }, Direction::N);
+		stepAll(arena);
+		CHECK_EQ(arena.nAlive(), 2u);
+		CHECK_EQ(arena.lastTick().moved, 2u);
+		CHECK((arena.getHead(follower) == Cell{ 1, 3 }));
+		CHECK_EQ(arena.owner(Cell{ 1, 3 }), static_cast<uint32_t>(follower) + 1);
+		CHECK(gridMatches(arena));
+	}
+}
+
+// a bad body throws with the arena as it was
+static void setSnakeValidatesFirst() {
+	ArenaSim arena = scene(2);
+	arena.setSnake(0, { { 2, 2 }, { 2, 3 } }, Direction::N);
+	const std::vector<std::vector<Cell>> invalid = {
+		{},
+		{ { 5, 5 }, { 5, 6 }, { 5, 5 } },	// repeats a cell
+		{ { 5, 5 }, { 5, 7 } },				// not connected
+		{ { 7, 5 }, { 8, 5 } },				// off the board
+		{ { 3, 2 }, { 2, 2 } },				// on snake 0
+	};
+	for (const std::vector<Cell>& body : invalid) {
+		CHECK_THROWS(arena.setSnake(1, body, Direction::N), std::invalid_argument);
+		CHECK_EQ(arena.nSegments(1), 1u);
+		CHECK((arena.getHead(1) == Cell{ 1, 7 }));
+		CHECK(gridMatches(arena));
+	}
+	CHECK_THROWS(arena.setSnake(2, { { 5, 5 } }, Direction::N), std::invalid_argument);
+	arena.setSnake(0, { { 2, 3 }, { 2, 4 } }, Direction::N); // may reuse its own cells
+	CHECK(gridMatches(arena));
+}
+
+int main() {
+	gridMatchesSnakesAndBaits();
+	headOnIntoSameCell();
+	swappingHeads();
+	followingAnotherTail();
+	setSnakeValidatesFirst();
+	return testResult();
+}
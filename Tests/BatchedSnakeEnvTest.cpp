@@ -0,0 +1,18 @@
+#include "BatchedSnakeEnv.h"
+#include "TestUtil.h"
+#include <stdexcept>
+
+static void boardSizeLimits() {
+	CHECK_EQ(BatchedSnakeEnv(1, 256, 256).width(), 256);
+	CHECK_EQ(BatchedSnakeEnv(1, 20, 20).nGames(), 1u);
+	CHECK_THROWS(BatchedSnakeEnv(1, 257, 256), std::invalid_argument);
+	CHECK_THROWS(BatchedSnakeEnv(1, 0, 20), std::invalid_argument);
+	CHECK_THROWS(BatchedSnakeEnv(1, 65536, 1), std::invalid_argument);		// x does not fit the int16 observation
+	CHECK_THROWS(BatchedSnakeEnv(1, 65537, 65537), std::invalid_argument);	// width * height overflows int
+	CHECK_THROWS(BatchedSnakeEnv(0, 20, 20), std::invalid_argument);
+}
+
+int main() {
+	boardSizeLimits();
+	return testResult();
+}
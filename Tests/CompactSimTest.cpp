@@ -0,0 +1,67 @@
+#include "Autopilot.h"
+#include "CompactSim.h"
+#include "GameSim.h"
+#include "TestUtil.h"
+#include <cstdint>
+#include <stdexcept>
+
+// snake, occupancy and flags of both games agree
+static bool sameState(const GameSim& g, const CompactSim& c) {
+	const Snake& s = g.getSnake();
+	bool same = g.isOver() == c.isOver() && g.isWon() == c.isWon() && g.score() == c.score() && g.ticks() == c.ticks();
+	if (!same || g.isOver()) return same;
+	same = s.getHead() == c.getHead() && s.getTail() == c.getTail() && s.nSegments() == c.nSegments()
+		&& s.getSize() == c.length() && s.getCurrentDirection() == c.direction() && g.getBait().getPos() == c.getBait();
+	for (int y = 0; y < g.height(); y++) {
+		for (int x = 0; x < g.width(); x++) same = same && g.getBoard().isFree(Cell{ x, y }) == c.isFree(x, y);
+	}
+	return same;
+}
+
+// GameSim and CompactSim stepped side by side from the same start, checked every tick. The
+// bait each places after eating is drawn differently (see CompactSim.h), so the compact game
+// takes GameSim's; everything else runs on its own. Autopilot for long games that wrap the
+// move ring, every other game with a random action (opposite turns among them) now and then
+// for the crashes.
+static void lockstepWithGameSim() {
+	for (uint64_t seed = 1; seed <= 40; seed++) {
+		const int width = 4 + static_cast<int>(seed % 29);
+		const int height = 4 + static_cast<int>((seed * 7) % 29);
+		const uint32_t randomEvery = seed % 2 ? 64 : 0;
+		GameSim g(width, height, seed);
+		CompactSim c;
+		c.assign(g);
+		CHECK(sameState(g, c));
+		Autopilot pilot;
+		Rng rng(seed * 3);
+		while (!g.isOver() && g.ticks() < 20000) {
+			const Action a = randomEvery && rng.below(randomEvery) == 0 ? static_cast<Action>(rng.below(5)) : pilot.decide(g);
+			const StepResult rg = g.step(a);
+			const StepResult rc = c.step(a);
+			CHECK_EQ(rg.ate, rc.ate);
+			CHECK_EQ(rg.gameOver, rc.gameOver);
+			CHECK_EQ(rg.won, rc.won);
+			if (rg.ate && !g.isOver()) c.setBait(g.getBait().getPos());
+			const bool same = sameState(g, c);
+			CHECK(same);
+			if (!same) break; // one report per game
+		}
+	}
+}
+
+static void setBaitNeedsFreeCell() {
+	GameSim g(8, 8, 1);
+	CompactSim c;
+	c.assign(g);
+	CHECK_THROWS(c.setBait(c.getHead()), std::invalid_argument);
+	CHECK_THROWS(c.setBait(Cell{ 8, 0 }), std::invalid_argument);
+	CHECK_THROWS(c.setBait(Cell{ 0, -1 }), std::invalid_argument);
+	c.setBait(Cell{ 0, 0 });
+	CHECK((c.getBait() == Cell{ 0, 0 }));
+}
+
+int main() {
+	lockstepWithGameSim();
+	setBaitNeedsFreeCell();
+	return testResult();
+}
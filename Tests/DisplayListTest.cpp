@@ -0,0 +1,72 @@
+#include "DisplayList.h"
+#include "Scene.h"
+#include "SerpentinePath.h"
+#include "TestUtil.h"
+#include <cstddef>
+#include <vector>
+
+// what a backend is asked to do: one call per state change, as GdiRenderer sets brush or
+// font and colours per call
+struct CallCounter : Renderer {
+	size_t calls = 0;
+	void clear(Color) override { calls++; }
+	void fillRect(const RectI&, Color) override { calls++; }
+	void fillRects(const RectI*, size_t, Color) override { calls++; }
+	void frameRect(const RectI&, Color) override { calls++; }
+	void drawText(const RectI&, const char*, const TextStyle&) override { calls++; }
+};
+
+// a snake of `length` on a serpentine inside the edge cells, head last: the board frame
+// overlaps the edge cells and lifts them one layer, which would be one more batch
+static void layOut(GameSim& sim, size_t length) {
+	SerpentinePath(1, 1, sim.width() - 2, sim.height() - 2).layout(sim, length);
+}
+
+static size_t frameBatches(size_t length, bool paused) {
+	GameSim sim(24, 24, 7);
+	layOut(sim, length);
+	SceneLayout layout;
+	layout.init(8, 24);
+	SceneStyle style;
+	SceneState st;
+	st.isPaused = paused;
+	st.status = "12.0 / 30.0 ms";
+
+	DisplayList list;
+	list.clear(style.background);
+	Scene::drawGamePlay(list, layout, style, sim, st);
+	CallCounter backend;
+	list.replay(backend);
+	CHECK_EQ(list.stats().batches, backend.calls);
+	return list.stats().batches;
+}
+
+// the state changes of a frame do not grow with the snake
+static void batchesConstantInSnakeLength() {
+	for (bool paused : { false, true }) {
+		const size_t shortSnake = frameBatches(3, paused);
+		const size_t longSnake = frameBatches(300, paused);
+		CHECK(shortSnake > 0);
+		CHECK_EQ(shortSnake, longSnake);
+	}
+}
+
+// texts of one style are still one backend call each
+static void textsCountOneBatchEach() {
+	DisplayList list;
+	TextStyle ts;
+	list.fillRect(RectI{ 0, 0, 10, 10 }, rgb(1, 2, 3));
+	list.fillRect(RectI{ 20, 0, 30, 10 }, rgb(1, 2, 3));
+	list.drawText(RectI{ 0, 20, 100, 40 }, "one", ts);
+	list.drawText(RectI{ 0, 40, 100, 60 }, "two", ts);
+	CallCounter backend;
+	list.replay(backend);
+	CHECK_EQ(list.stats().batches, 3u);
+	CHECK_EQ(backend.calls, 3u);
+}
+
+int main() {
+	batchesConstantInSnakeLength();
+	textsCountOneBatchEach();
+	return testResult();
+}
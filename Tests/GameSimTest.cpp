@@ -0,0 +1,47 @@
+#include "GameSim.h"
+#include "TestUtil.h"
+#include <stdexcept>
+#include <vector>
+
+static std::vector<Cell> bodyOf(const GameSim& sim) {
+	std::vector<Cell> body;
+	for (size_t i = 0; i < sim.getSnake().nSegments(); i++) body.push_back(sim.getSnake().getSegment(i));
+	return body;
+}
+
+static void setSnakeBodyReplacesSnake() {
+	GameSim sim(10, 10, 1);
+	const std::vector<Cell> body = { { 4, 4 }, { 4, 5 }, { 4, 6 }, { 5, 6 } };
+	sim.setSnakeBody(body, Direction::N);
+	CHECK(bodyOf(sim) == body);
+	for (const Cell& c : body) CHECK(!sim.getBoard().isFree(c));
+	CHECK(sim.getBoard().isFree(Cell{ 5, 5 }));
+}
+
+// an invalid body throws before anything is cleared: snake and board stay as they were
+static void setSnakeBodyInvalidLeavesGameUntouched() {
+	GameSim sim(10, 10, 1);
+	for (int i = 0; i < 5; i++) sim.step(Action::None);
+	const std::vector<Cell> before = bodyOf(sim);
+	const uint64_t hash = sim.hash();
+
+	const std::vector<std::vector<Cell>> invalid = {
+		{},
+		{ { 1, 1 }, { 1, 2 }, { 1, 1 } },	// repeats a cell
+		{ { 1, 1 }, { 3, 1 } },				// not connected
+		{ { 9, 9 }, { 10, 9 } },			// off the board
+		{ { 0, 0 }, { -5, 0 } },
+	};
+	for (const std::vector<Cell>& body : invalid) {
+		CHECK_THROWS(sim.setSnakeBody(body, Direction::N), std::invalid_argument);
+		CHECK(bodyOf(sim) == before);
+		CHECK_EQ(sim.hash(), hash);
+		for (const Cell& c : before) CHECK(!sim.getBoard().isFree(c));
+	}
+}
+
+int main() {
+	setSnakeBodyReplacesSnake();
+	setSnakeBodyInvalidLeavesGameUntouched();
+	return testResult();
+}
@@ -0,0 +1,110 @@
+#include "LargeBoardSim.h"
+#include "SerpentinePath.h"
+#include "TestUtil.h"
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+static std::vector<Cell> bodyOf(const LargeBoardSim& sim) {
+	std::vector<Cell> body;
+	for (size_t i = 0; i < sim.nSegments(); i++) body.push_back(sim.getSegment(i));
+	return body;
+}
+
+static void setSnakeBodyReplacesSnake() {
+	LargeBoardSim sim(100000, 100000, 1);
+	const std::vector<Cell> body = { { 70000, 4 }, { 70000, 5 }, { 70001, 5 }, { 70002, 5 } };
+	sim.setSnakeBody(body, Direction::N);
+	CHECK(bodyOf(sim) == body);
+	for (const Cell& c : body) CHECK(!sim.isFree(c));
+	CHECK(sim.isFree(sim.startCell()));
+	CHECK_EQ(sim.getGrid().count(), static_cast<uint64_t>(body.size()));
+}
+
+// an invalid body throws before anything is cleared: snake and grid stay as they were
+static void setSnakeBodyInvalidLeavesGameUntouched() {
+	LargeBoardSim sim(100000, 100000, 1);
+	for (int i = 0; i < 5; i++) sim.step(Action::None);
+	const std::vector<Cell> before = bodyOf(sim);
+	const uint64_t count = sim.getGrid().count();
+
+	const std::vector<std::vector<Cell>> invalid = {
+		{},
+		{ { 1, 1 }, { 1, 2 }, { 1, 1 } },				// repeats a cell
+		{ { 1, 1 }, { 3, 1 } },							// not connected
+		{ { 99999, 9 }, { 100000, 9 } },				// off the board
+		{ { 0, 0 }, { -5, 0 } },
+	};
+	for (const std::vector<Cell>& body : invalid) {
+		CHECK_THROWS(sim.setSnakeBody(body, Direction::N), std::invalid_argument);
+		CHECK(bodyOf(sim) == before);
+		CHECK_EQ(sim.getGrid().count(), count);
+		for (const Cell& c : before) CHECK(!sim.isFree(c));
+	}
+}
+
+static void fullBoardIsWon() {
+	LargeBoardSim one(1, 1, 3);
+	CHECK(one.isOver());
+	CHECK(one.isWon());
+	StepResult r = one.step(Action::None);
+	CHECK(r.gameOver);
+	CHECK(r.won);
+
+	LargeBoardSim sim(70, 3, 3);
+	sim.setSnakeBody(SerpentinePath(70, 3).body(70 * 3), Direction::S);
+	CHECK(sim.isOver());
+	CHECK(sim.isWon());
+	CHECK(sim.step(Action::None).won);
+
+	sim.reset(4);
+	CHECK(!sim.isOver());
+	sim.setSnakeBody(SerpentinePath(70, 3).body(70 * 3 - 1), Direction::S);
+	CHECK(!sim.isOver());
+	CHECK((sim.getBait() == Cell{ 69, 2 }));
+}
+
+// a nearly full board misses kBaitTries times; the scan still puts the bait on a free cell,
+// and over many draws on each of them
+static void placeBaitOnNearlyFullBoard() {
+	const int width = 130, height = 3, nFree = 3;
+	LargeBoardSim sim(width, height, 5);
+	sim.setSnakeBody(SerpentinePath(width, height).body(width * height - nFree), Direction::S);
+	std::set<std::pair<int, int>> hit;
+	for (int i = 0; i < 2000; i++) {
+		CHECK(sim.placeBait());
+		Cell b = sim.getBait();
+		CHECK(sim.isInside(b));
+		CHECK(sim.isFree(b));
+		hit.insert({ b.x, b.y });
+	}
+	CHECK_EQ(hit.size(), static_cast<size_t>(nFree));
+}
+
+// nthFree enumerates every free cell exactly once, on tiles that exist and ones that do not
+static void nthFreeVisitsEveryFreeCell() {
+	const int width = 150, height = 70;
+	SparseGrid grid(width, height);
+	Rng rng(9);
+	for (int i = 0; i < 4000; i++) grid.testAndSet(Cell{ static_cast<int>(rng.below(100)), static_cast<int>(rng.below(height)) });
+	const uint64_t nFree = static_cast<uint64_t>(width) * height - grid.count();
+	std::set<std::pair<int, int>> seen;
+	for (uint64_t k = 0; k < nFree; k++) {
+		Cell c = grid.nthFree(k);
+		CHECK(grid.isInside(c));
+		CHECK(!grid.test(c));
+		seen.insert({ c.x, c.y });
+	}
+	CHECK_EQ(seen.size(), static_cast<size_t>(nFree));
+}
+
+int main() {
+	setSnakeBodyReplacesSnake();
+	setSnakeBodyInvalidLeavesGameUntouched();
+	fullBoardIsWon();
+	placeBaitOnNearlyFullBoard();
+	nthFreeVisitsEveryFreeCell();
+	return testResult();
+}
@@ -0,0 +1,48 @@
+#include "Autopilot.h"
+#include "ParallelRunner.h"
+#include "TestUtil.h"
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+static std::vector<EpisodeResult> run(unsigned nThreads, size_t grain) {
+	ParallelRunner runner(nThreads);
+	// Autopilot keeps state between calls: one per thread, as runEpisodes hands them out
+	return runner.runEpisodes(96, 16, 16, 42, [] { return Policy(Autopilot()); }, 600, grain);
+}
+
+// episode i gets the same seed and plays out the same whichever thread runs it
+static void sameResultsOnAnyThreadCount() {
+	const std::vector<EpisodeResult> one = run(1, 16);
+	CHECK_EQ(one.size(), 96u);
+	for (size_t i = 0; i < one.size(); i++) CHECK_EQ(one[i].seed, ParallelRunner::episodeSeed(42, i));
+
+	for (unsigned nThreads : { 2u, 4u, 7u }) {
+		for (size_t grain : { size_t(1), size_t(16) }) {
+			const std::vector<EpisodeResult> many = run(nThreads, grain);
+			CHECK_EQ(many.size(), one.size());
+			for (size_t i = 0; i < one.size() && i < many.size(); i++) {
+				const bool same = many[i].seed == one[i].seed && many[i].score == one[i].score
+					&& many[i].ticks == one[i].ticks && many[i].won == one[i].won;
+				if (!same) std::fprintf(stderr, "episode %zu differs on %u threads, grain %zu\n", i, nThreads, grain);
+				CHECK(same);
+			}
+		}
+	}
+}
+
+static void parallelForCoversEachIndexOnce() {
+	ParallelRunner runner(4);
+	std::vector<std::atomic<int>> hits(1000);
+	for (std::atomic<int>& h : hits) h = 0;
+	runner.parallelFor(hits.size(), 7, [&](size_t begin, size_t end, unsigned) {
+		for (size_t i = begin; i < end; i++) hits[i]++;
+	});
+	for (const std::atomic<int>& h : hits) CHECK_EQ(h.load(), 1);
+}
+
+int main() {
+	sameResultsOnAnyThreadCount();
+	parallelForCoversEachIndexOnce();
+	return testResult();
+}
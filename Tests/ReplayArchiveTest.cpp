@@ -0,0 +1,233 @@
+#include "Autopilot.h"
+#include "ReplayArchive.h"
+#include "TestUtil.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static std::string tempPath(const char* name) {
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static Replay playGame(size_t i) {
+	Autopilot pilot;
+	GameSim sim(12, 12, ParallelRunner::episodeSeed(3, i));
+	ReplayRecorder rec;
+	rec.begin(sim);
+	while (!sim.isOver() && sim.ticks() < 300) {
+		sim.step(pilot.decide(sim));
+		rec.onStep(sim);
+	}
+	return rec.finish(sim);
+}
+
+static void writeArchive(const std::filesystem::path& path, size_t nGames) {
+	std::filesystem::remove(path);
+	ReplayArchiveWriter writer(path);
+	for (size_t i = 0; i < nGames; i++) writer.append(playGame(i));
+}
+
+// the archive holds games 0 .. n - 1 of playGame
+static bool holdsGames(const std::filesystem::path& path, size_t n) {
+	ReplayArchive archive(path);
+	if (!archive.isOpen() || archive.count() != n) return false;
+	for (size_t i = 0; i < n; i++) {
+		Replay r;
+		if (!archive.decode(i, r) || r.seed != ParallelRunner::episodeSeed(3, i)) return false;
+	}
+	return true;
+}
+
+static std::vector<char> readAll(const std::string& path) {
+	std::ifstream f(path, std::ios::binary);
+	return std::vector<char>(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+static void writeAll(const std::string& path, const char* data, size_t size) {
+	std::ofstream f(path, std::ios::binary | std::ios::trunc);
+	f.write(data, static_cast<std::streamsize>(size));
+}
+
+template<class T>
+static T readAt(const std::string& path, uint64_t offset) {
+	T v;
+	std::ifstream f(path, std::ios::binary);
+	f.seekg(static_cast<std::streamoff>(offset));
+	f.read(reinterpret_cast<char*>(&v), sizeof(v));
+	return v;
+}
+
+template<class T>
+static void writeAt(const std::string& path, uint64_t offset, const T& v) {
+	std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+	f.seekp(static_cast<std::streamoff>(offset));
+	f.write(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+static void roundTrip() {
+	const std::string path = tempPath("SnakeTests-roundtrip.snka");
+	writeArchive(path, 5);
+	ReplayArchive archive(path);
+	CHECK(archive.isOpen());
+	CHECK_EQ(archive.count(), 5u);
+	for (size_t i = 0; i < archive.count(); i++) {
+		Replay r;
+		CHECK(archive.decode(i, r));
+		CHECK_EQ(r.seed, ParallelRunner::episodeSeed(3, i));
+	}
+	archive.close();
+	ReplayArchiveWriter writer;
+	CHECK(writer.open(path));
+	CHECK_EQ(writer.count(), 5u);
+	writer.close();
+	std::filesystem::remove(path);
+}
+
+// A writer that dies between append and flush leaves the file cut anywhere in what that
+// append and flush would have written; every such cut still opens with the earlier games,
+// for readers and for the next writer, which writes over the torn tail.
+static void tornAppendKeepsEarlierReplays() {
+	const std::string path = tempPath("SnakeTests-torn.snka");
+	const std::string cut = tempPath("SnakeTests-torn-cut.snka");
+	writeArchive(path, 3);
+	const uint64_t before = std::filesystem::file_size(path);
+	{
+		ReplayArchiveWriter writer(path);
+		CHECK(writer.append(playGame(3)));
+		std::filesystem::copy_file(path, cut, std::filesystem::copy_options::overwrite_existing); // killed here
+		CHECK(holdsGames(cut, 3));
+		CHECK(writer.flush());
+	}
+	CHECK(holdsGames(path, 4));
+
+	const std::vector<char> full = readAll(path);
+	CHECK(full.size() > before);
+	for (size_t size = static_cast<size_t>(before); size < full.size(); size++) {
+		writeAll(cut, full.data(), size);
+		if (!holdsGames(cut, 3)) {
+			CHECK(holdsGames(cut, 3));
+			break; // one report
+		}
+	}
+
+	writeAll(cut, full.data(), full.size() - 5);
+	{
+		ReplayArchiveWriter writer(cut);
+		CHECK_EQ(writer.count(), 3u);
+		CHECK(writer.append(playGame(3)));
+	}
+	CHECK(holdsGames(cut, 4));
+	std::filesystem::remove(cut);
+	std::filesystem::remove(path);
+}
+
+// open, append, flush after every game, as the desktop game does: the index copies left
+// behind are compacted away, so the file stays within a bound of the live bytes
+static void compactsDeadIndexCopies() {
+	const std::string path = tempPath("SnakeTests-compact.snka");
+	std::filesystem::remove(path);
+	const size_t nGames = 400;
+	uint64_t replayBytes = 0;
+	uint64_t dead = 0;
+	int compactions = 0;
+	for (size_t i = 0; i < nGames; i++) {
+		ReplayArchiveWriter writer(path);
+		CHECK_EQ(writer.count(), i);
+		const Replay r = playGame(i);
+		replayBytes += r.encode().size();
+		CHECK(writer.append(r));
+		CHECK(writer.flush());
+		if (writer.deadBytes() < dead) compactions++;
+		dead = writer.deadBytes();
+		const uint64_t live = replayBytes + (i + 1) * sizeof(ArchiveEntry) + sizeof(ArchiveFooter);
+		CHECK(std::filesystem::file_size(path) <= 2 * live + ReplayArchiveWriter::kCompactSlack + (i + 1) * sizeof(ArchiveEntry) + sizeof(ArchiveFooter));
+	}
+	CHECK(compactions > 0);
+	CHECK(holdsGames(path, nGames));
+	std::filesystem::remove(path);
+}
+
+// writer and reader both take a path, so a folder name outside the ANSI code page (a
+// %LOCALAPPDATA% under such a user name) works both ways
+static void nonAsciiPath() {
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / std::filesystem::u8path("SnakeTests-\xc3\xa9l\xc3\xa8ve-\xe8\x9b\x87");
+	std::filesystem::create_directories(dir);
+	const std::filesystem::path path = dir / "replays.snka";
+	writeArchive(path, 2);
+	ReplayArchive archive(path);
+	CHECK(archive.isOpen());
+	CHECK_EQ(archive.count(), 2u);
+	archive.close();
+	std::filesystem::remove_all(dir);
+}
+
+// a long headless game's default duration saturates instead of wrapping to a short one
+static void durationSaturates() {
+	CHECK_EQ(ReplayArchiveWriter::defaultDurationMs(0), 0u);
+	CHECK_EQ(ReplayArchiveWriter::defaultDurationMs(1000), 1000u * ReplayArchiveWriter::kDefaultTickMs);
+	CHECK_EQ(ReplayArchiveWriter::defaultDurationMs(UINT32_MAX / ReplayArchiveWriter::kDefaultTickMs),
+		(UINT32_MAX / ReplayArchiveWriter::kDefaultTickMs) * ReplayArchiveWriter::kDefaultTickMs);
+	CHECK_EQ(ReplayArchiveWriter::defaultDurationMs(UINT32_MAX / ReplayArchiveWriter::kDefaultTickMs + 1), UINT32_MAX);
+	CHECK_EQ(ReplayArchiveWriter::defaultDurationMs(uint64_t(1) << 62), UINT32_MAX);
+
+	const std::string path = tempPath("SnakeTests-duration.snka");
+	std::filesystem::remove(path);
+	{
+		Replay r;
+		r.ticks = 50000000; // 5 * 10^9 ms
+		ReplayArchiveWriter writer(path);
+		CHECK(writer.append(r));
+	}
+	ReplayArchive archive(path);
+	CHECK_EQ(archive.count(), 1u);
+	if (archive.count() == 1) CHECK_EQ(archive.entry(0).durationMs, UINT32_MAX);
+	archive.close();
+	std::filesystem::remove(path);
+}
+
+// count + 2^61 entries of 40 bytes is the same size modulo 2^64: a check written as
+// indexOffset + count * 40 + 24 == size passes it and reads the index past the mapping
+static void rejectsWrappingCount() {
+	const std::string path = tempPath("SnakeTests-count.snka");
+	writeArchive(path, 3);
+	const uint64_t size = std::filesystem::file_size(path);
+	const uint64_t countAt = size - sizeof(ArchiveFooter) + offsetof(ArchiveFooter, count);
+	writeAt<uint64_t>(path, countAt, readAt<uint64_t>(path, countAt) + (uint64_t(1) << 61));
+
+	ReplayArchive archive;
+	CHECK(!archive.open(path));
+	CHECK_EQ(archive.count(), 0u);
+	ReplayArchiveWriter writer;
+	CHECK(!writer.open(path));
+	std::filesystem::remove(path);
+}
+
+// an entry whose offset + length wraps around to a small number
+static void rejectsWrappingEntry() {
+	const std::string path = tempPath("SnakeTests-entry.snka");
+	writeArchive(path, 3);
+	const uint64_t size = std::filesystem::file_size(path);
+	const uint64_t indexOffset = readAt<uint64_t>(path, size - sizeof(ArchiveFooter) + offsetof(ArchiveFooter, indexOffset));
+	const uint64_t entry1 = indexOffset + sizeof(ArchiveEntry);
+	writeAt<uint64_t>(path, entry1 + offsetof(ArchiveEntry, offset), UINT64_MAX - 4);
+
+	ReplayArchive archive;
+	CHECK(!archive.open(path));
+	CHECK_EQ(archive.count(), 0u);
+	std::filesystem::remove(path);
+}
+
+int main() {
+	roundTrip();
+	nonAsciiPath();
+	tornAppendKeepsEarlierReplays();
+	compactsDeadIndexCopies();
+	durationSaturates();
+	rejectsWrappingCount();
+	rejectsWrappingEntry();
+	return testResult();
+}
@@ -0,0 +1,155 @@
+#include "Autopilot.h"
+#include "ParallelRunner.h"
+#include "Replay.h"
+#include "TestUtil.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// what a game looks like after a tick, compared field by field
+struct State {
+	uint64_t hash = 0;
+	int score = 0;
+	bool isOver = false;
+	Cell bait;
+	Rng rng;
+	std::vector<Cell> body;
+
+	bool operator==(const State& o) const {
+		return hash == o.hash && score == o.score && isOver == o.isOver && bait == o.bait && rng == o.rng && body == o.body;
+	}
+};
+
+static State stateOf(const GameSim& sim) {
+	State s;
+	s.hash = sim.hash();
+	s.score = sim.score();
+	s.isOver = sim.isOver();
+	s.bait = sim.getBait().getPos();
+	s.rng = sim.getRng();
+	for (size_t i = 0; i < sim.getSnake().nSegments(); i++) s.body.push_back(sim.getSnake().getSegment(i));
+	return s;
+}
+
+struct Recorded {
+	Replay replay;
+	std::vector<State> states; // states[t] is the game after tick t
+};
+
+// Plays with the autopilot, and every few ticks turns with Snake::setDirection like the keyboard
+// does; keyboardEvery == 0 never does, keyboardEvery == 1 only uses the keyboard.
+static Recorded record(uint64_t seed, uint32_t keyboardEvery, uint64_t maxTicks) {
+	Autopilot pilot;
+	Rng keys(seed ^ 0x5EED);
+	GameSim sim(14, 10, seed);
+	ReplayRecorder rec;
+	Recorded out;
+	rec.begin(sim);
+	out.states.push_back(stateOf(sim));
+	while (!sim.isOver() && sim.ticks() < maxTicks) {
+		if (keyboardEvery && keys.below(keyboardEvery) == 0) {
+			sim.getSnake().setDirection(static_cast<Direction>(keys.below(4)));
+			sim.step();
+		} else {
+			sim.step(pilot.decide(sim));
+		}
+		rec.onStep(sim);
+		out.states.push_back(stateOf(sim));
+	}
+	out.replay = rec.finish(sim);
+	return out;
+}
+
+static std::vector<Recorded> games() {
+	std::vector<Recorded> out;
+	for (size_t i = 0; i < 6; i++) {
+		uint64_t seed = ParallelRunner::episodeSeed(11, i);
+		out.push_back(record(seed, 0, 2000));
+		out.push_back(record(seed, 5, 2000));
+		out.push_back(record(seed, 1, 2000));
+	}
+	return out;
+}
+
+static void decodeRestoresReplay(const std::vector<Recorded>& all) {
+	for (const Recorded& g : all) {
+		std::vector<uint8_t> bytes = g.replay.encode();
+		Replay r;
+		CHECK(Replay::decode(bytes.data(), bytes.size(), r));
+		CHECK_EQ(r.width, g.replay.width);
+		CHECK_EQ(r.height, g.replay.height);
+		CHECK_EQ(r.seed, g.replay.seed);
+		CHECK_EQ(r.ticks, g.replay.ticks);
+		CHECK_EQ(r.score, g.replay.score);
+		CHECK_EQ(r.turns.size(), g.replay.turns.size());
+		for (size_t i = 0; i < r.turns.size() && i < g.replay.turns.size(); i++) {
+			CHECK_EQ(r.turns[i].tick, g.replay.turns[i].tick);
+			CHECK(r.turns[i].dir == g.replay.turns[i].dir);
+		}
+		CHECK(!Replay::decode(bytes.data(), bytes.size() - 1, r));
+	}
+}
+
+static void playbackMatchesEveryTick(const std::vector<Recorded>& all) {
+	size_t nKeyboardTurns = 0;
+	for (const Recorded& g : all) {
+		std::vector<uint8_t> bytes = g.replay.encode();
+		Replay r;
+		CHECK(Replay::decode(bytes.data(), bytes.size(), r));
+		nKeyboardTurns += r.turns.size();
+		ReplayPlayer player(r);
+		CHECK(stateOf(player.sim()) == g.states[0]);
+		while (player.stepForward()) {
+			CHECK(player.tick() < g.states.size());
+			if (player.tick() >= g.states.size()) break;
+			CHECK(stateOf(player.sim()) == g.states[player.tick()]);
+		}
+		CHECK_EQ(player.tick(), g.replay.ticks);
+		CHECK_EQ(player.sim().score(), g.replay.score);
+		CHECK_EQ(player.tick() + 1, g.states.size());
+	}
+	CHECK(nKeyboardTurns > 0);
+}
+
+static void seekMatchesLinearPlayback(const std::vector<Recorded>& all) {
+	const uint64_t interval = 16;
+	for (const Recorded& g : all) {
+		const uint64_t n = g.replay.ticks;
+		ReplayPlayer player(g.replay, interval);
+		auto landsOn = [&](uint64_t tick) {
+			player.seek(tick);
+			uint64_t t = tick < n ? tick : n;
+			CHECK_EQ(player.tick(), t);
+			CHECK(stateOf(player.sim()) == g.states[t]);
+		};
+		// forward past keyframes that do not exist yet, then back onto and between the ones made
+		landsOn(n / 2 + 3);
+		size_t made = player.nKeyframes();
+		CHECK(made >= 1);
+		landsOn(n / 3);
+		landsOn(0);
+		landsOn(interval);
+		landsOn(interval - 1);
+		// past the last keyframe taken, and past the end of the replay
+		landsOn((made - 1) * interval + 5);
+		landsOn(n);
+		landsOn(n + 100);
+		CHECK(player.nKeyframes() >= made);
+		for (uint64_t t = n; t-- > 0;) {
+			if (t % 7 == 0 || t % interval == 0 || t % interval == interval - 1) landsOn(t);
+		}
+		// a fresh player seeking straight past the end
+		ReplayPlayer fresh(g.replay, interval);
+		fresh.seek(n + 1);
+		CHECK_EQ(fresh.tick(), n);
+		CHECK(stateOf(fresh.sim()) == g.states[n]);
+	}
+}
+
+int main() {
+	std::vector<Recorded> all = games();
+	decodeRestoresReplay(all);
+	playbackMatchesEveryTick(all);
+	seekMatchesLinearPlayback(all);
+	return testResult();
+}
@@ -0,0 +1,68 @@
+#include "Rng.h"
+#include "TestUtil.h"
+#include <cstdint>
+
+// Known answers: replays and parallel runs are only reproducible while these stay put.
+
+// xoshiro256** from the state { 1, 2, 3, 4 }, the vectors other implementations test against
+static void nextMatchesReference() {
+	const uint64_t state[4] = { 1, 2, 3, 4 };
+	const uint64_t want[10] = {
+		11520ULL, 0ULL, 1509978240ULL, 1215971899390074240ULL, 1216172134540287360ULL,
+		607988272756665600ULL, 16172922978634559625ULL, 8476171486693032832ULL,
+		10595114339597558777ULL, 2904607092377533576ULL,
+	};
+	Rng rng(state);
+	for (uint64_t w : want) CHECK_EQ(rng.next(), w);
+}
+
+static void splitmix64MatchesReference() {
+	uint64_t state = 0;
+	CHECK_EQ(Rng::splitmix64(state), 0xE220A8397B1DCDAFULL);
+	CHECK_EQ(Rng::splitmix64(state), 0x6E789E6AA1B965F4ULL);
+	CHECK_EQ(Rng::splitmix64(state), 0x06C45D188009454FULL);
+	CHECK_EQ(state, 3 * 0x9E3779B97F4A7C15ULL);
+}
+
+// seeding through splitmix64, below() and jump() pinned for seed 42
+static void seededStreamIsPinned() {
+	Rng rng(42);
+	CHECK_EQ(rng.next(), 0x15780B2E0C2EC716ULL);
+	CHECK_EQ(rng.next(), 0x6104D9866D113A7EULL);
+	CHECK_EQ(rng.next(), 0xAE17533239E499A1ULL);
+	CHECK_EQ(rng.next(), 0xECB8AD4703B360A1ULL);
+
+	Rng b(42);
+	const uint32_t n[7] = { 1, 2, 6, 20, 1000, 0xFFFFFFFFu, 0x80000001u };
+	const uint32_t want[7] = { 0, 0, 4, 18, 991, 3306005808u, 1635039033u };
+	for (int i = 0; i < 7; i++) CHECK_EQ(b.below(n[i]), want[i]);
+
+	Rng j(42);
+	j.jump();
+	const uint64_t jumped[4] = { 0x81746704FDE896B5ULL, 0x645E944932DAE0AEULL, 0xF4776829231C282CULL, 0x2393F9798732DBA1ULL };
+	CHECK(j == Rng(jumped));
+	CHECK_EQ(j.next(), 0x50086EF83CBF4F4AULL);
+	CHECK_EQ(j.next(), 0xBA285EC21347D703ULL);
+
+	Rng s(42);
+	Rng first = s.split();
+	CHECK(first == Rng(42));
+	CHECK(s == Rng(jumped));
+}
+
+static void belowStaysInRange() {
+	Rng rng(7);
+	for (int i = 0; i < 100000; i++) {
+		CHECK_EQ(rng.below(1), 0u);
+		CHECK(rng.below(0xFFFFFFFFu) < 0xFFFFFFFFu);
+		CHECK(rng.below(2) < 2u);
+	}
+}
+
+int main() {
+	nextMatchesReference();
+	splitmix64MatchesReference();
+	seededStreamIsPinned();
+	belowStaysInRange();
+	return testResult();
+}
@@ -0,0 +1,3 @@
+// SpanFill.cpp once more for SpanFillAvx2Test: source file properties are per directory, so the
+// AVX2 flag goes on this file rather than on the library's copy.
+#include "SpanFill.cpp"
@@ -0,0 +1,83 @@
+#include "SpanFill.h"
+#include "TestUtil.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Built three times (Tests/CMakeLists.txt): with whatever path SnakeSim was configured for, and
+// with SpanFill.cpp compiled in for SNAKESIM_NO_SIMD and for AVX2; argv[1] names the path expected.
+
+static constexpr int kSkipped = 77; // CTest SKIP_RETURN_CODE
+static constexpr size_t kGuard = 64;
+static constexpr size_t kMaxLen = 80;
+static constexpr uint8_t kSentinel = 0xCD;
+
+static bool cpuHasAvx2() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	int r[4];
+	__cpuid(r, 0);
+	if (r[0] < 7) return false;
+	__cpuid(r, 1);
+	bool osSavesYmm = (r[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+	__cpuidex(r, 7, 0);
+	return osSavesYmm && (r[1] & (1 << 5));
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+// every length 0 .. kMaxLen at every start alignment 0 .. 31 against a plain loop, the guard
+// bytes around the span included
+static void fill32MatchesLoop() {
+	alignas(64) uint8_t got[kGuard + kMaxLen * 4 + kGuard];
+	alignas(64) uint8_t want[sizeof(got)];
+	const uint32_t v = 0x11223344u;
+	for (size_t align = 0; align < 32; align++) {
+		for (size_t n = 0; n <= kMaxLen; n++) {
+			std::memset(got, kSentinel, sizeof(got));
+			std::memset(want, kSentinel, sizeof(want));
+			uint8_t* dst = got + kGuard - 32 + align;
+			uint8_t* ref = want + kGuard - 32 + align;
+			SpanFill::fill32(dst, n, v);
+			for (size_t i = 0; i < n; i++) std::memcpy(ref + i * 4, &v, 4);
+			CHECK(std::memcmp(got, want, sizeof(got)) == 0);
+		}
+	}
+}
+
+static void fill8MatchesLoop() {
+	alignas(64) uint8_t got[kGuard + kMaxLen + kGuard];
+	alignas(64) uint8_t want[sizeof(got)];
+	for (uint8_t v : { uint8_t(0x00), uint8_t(0x5A), uint8_t(0xFF) }) {
+		for (size_t align = 0; align < 32; align++) {
+			for (size_t n = 0; n <= kMaxLen; n++) {
+				std::memset(got, kSentinel, sizeof(got));
+				std::memset(want, kSentinel, sizeof(want));
+				uint8_t* dst = got + kGuard - 32 + align;
+				uint8_t* ref = want + kGuard - 32 + align;
+				SpanFill::fill8(dst, n, v);
+				for (size_t i = 0; i < n; i++) ref[i] = v;
+				CHECK(std::memcmp(got, want, sizeof(got)) == 0);
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	std::string path = SpanFill::path();
+	if (argc > 1) CHECK_EQ(path, std::string(argv[1]));
+	if (path == "avx2" && !cpuHasAvx2()) {
+		std::printf("no AVX2 on this CPU, skipped\n");
+		return kSkipped;
+	}
+	fill32MatchesLoop();
+	fill8MatchesLoop();
+	return testResult();
+}
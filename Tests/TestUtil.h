@@ -0,0 +1,32 @@
+#pragma once
+
+// Checks shared by the test programs. Each Tests/*Test.cpp is one executable registered with
+// CTest; a failed CHECK prints where and what and the program goes on, main() returns
+// testResult(), non-zero once anything failed.
+
+#include <cstdio>
+
+namespace testutil {
+	inline int& failures() { static int n = 0; return n; }
+
+	inline void fail(const char* file, int line, const char* what) {
+		std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+		failures()++;
+	}
+}
+
+#define CHECK(cond) do { if (!(cond)) testutil::fail(__FILE__, __LINE__, #cond); } while (0)
+#define CHECK_EQ(a, b) do { if (!((a) == (b))) testutil::fail(__FILE__, __LINE__, #a " == " #b); } while (0)
+#define CHECK_THROWS(expr, type) do { \
+	bool thrown_ = false; \
+	try { expr; } catch (const type&) { thrown_ = true; } \
+	if (!thrown_) testutil::fail(__FILE__, __LINE__, #expr " throws " #type); \
+} while (0)
+
+inline int testResult() {
+	if (testutil::failures() > 0) {
+		std::fprintf(stderr, "%d check(s) failed\n", testutil::failures());
+		return 1;
+	}
+	return 0;
+}
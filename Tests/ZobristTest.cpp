@@ -0,0 +1,126 @@
+#include "Autopilot.h"
+#include "GameSim.h"
+#include "TestUtil.h"
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+#include <cstdint>
+#include <vector>
+
+// the hash as Zobrist.h defines it, from nothing
+static uint64_t rehashed(const GameSim& sim) {
+	const Snake& s = sim.getSnake();
+	uint64_t h = zobristKey(ZobristFeature::Head, s.getHead())
+		^ zobristKey(ZobristFeature::Direction, static_cast<uint64_t>(s.getCurrentDirection()))
+		^ zobristKey(ZobristFeature::Growth, static_cast<uint64_t>(s.getPendingGrowth()))
+		^ zobristKey(ZobristFeature::Bait, sim.getBait().getPos());
+	for (size_t i = 0; i < s.nSegments(); i++) h ^= zobristKey(ZobristFeature::Body, s.getSegment(i));
+	return h;
+}
+
+// GameSim::hash() is updated move by move; every tick it must equal the hash rebuilt from
+// the state, through turns, growth, bait moves and setSnakeBody
+static void incrementalHashMatchesRehash() {
+	for (uint64_t seed = 1; seed <= 24; seed++) {
+		GameSim sim(8 + static_cast<int>(seed % 9), 8 + static_cast<int>((seed * 5) % 9), seed);
+		CHECK_EQ(sim.hash(), rehashed(sim));
+		Autopilot pilot;
+		Rng rng(seed);
+		while (!sim.isOver() && sim.ticks() < 5000) {
+			const Action a = rng.below(64) == 0 ? static_cast<Action>(rng.below(5)) : pilot.decide(sim);
+			sim.step(a);
+			if (sim.isOver()) break;
+			const bool same = sim.hash() == rehashed(sim);
+			CHECK(same);
+			if (!same) break; // one report per game
+		}
+	}
+
+	GameSim sim(10, 10, 3);
+	sim.setSnakeBody({ { 2, 2 }, { 2, 3 }, { 3, 3 }, { 4, 3 } }, Direction::N);
+	CHECK_EQ(sim.hash(), rehashed(sim));
+	sim.step(Action::E);
+	CHECK_EQ(sim.hash(), rehashed(sim));
+}
+
+// the same state, reached on two paths, hashes the same; a different direction does not
+static void hashIsStateOnly() {
+	GameSim a(10, 10, 5);
+	GameSim b(10, 10, 5);
+	const std::vector<Cell> body = { { 5, 5 }, { 5, 6 }, { 5, 7 } };
+	a.setSnakeBody(body, Direction::N);
+	b.setSnakeBody({ { 1, 1 }, { 1, 2 } }, Direction::E);
+	b.setSnakeBody(body, Direction::N);
+	CHECK_EQ(a.hash(), b.hash());
+	b.setSnakeBody(body, Direction::E);
+	CHECK(a.hash() != b.hash());
+}
+
+static TTEntry entry(float value, uint16_t depth, uint8_t move = 0) {
+	TTEntry e;
+	e.value = value;
+	e.depth = depth;
+	e.move = move;
+	e.flags = 0x55;
+	return e;
+}
+
+static void probeReturnsStored() {
+	TranspositionTable tt(1024);
+	TTEntry out;
+	CHECK(!tt.probe(0x1234, out));
+	tt.store(0x1234, entry(-2.5f, 300, 3));
+	CHECK(tt.probe(0x1234, out));
+	CHECK_EQ(out.value, -2.5f);
+	CHECK_EQ(out.depth, 300);
+	CHECK_EQ(out.move, 3);
+	CHECK_EQ(out.flags, 0x55);
+	CHECK(!tt.probe(0x1235, out));
+	tt.clear();
+	CHECK(!tt.probe(0x1234, out));
+}
+
+// a second store of one state takes its entry, whatever the depths, and leaves the rest
+static void sameStateOverwrites() {
+	TranspositionTable tt(TranspositionTable::kWays); // one bucket
+	const uint64_t other[] = { 0x100, 0x200, 0x300 };
+	for (uint64_t h : other) tt.store(h, entry(1.0f, 1));
+	tt.store(0x400, entry(1.0f, 9));
+	tt.store(0x400, entry(2.0f, 2));
+	TTEntry out;
+	CHECK(tt.probe(0x400, out));
+	CHECK_EQ(out.value, 2.0f);
+	CHECK_EQ(out.depth, 2);
+	for (uint64_t h : other) CHECK(tt.probe(h, out));
+}
+
+// a full bucket gives up the entry searched least deep
+static void fullBucketReplacesShallowest() {
+	TranspositionTable tt(64);
+	const size_t nBuckets = tt.capacity() / TranspositionTable::kWays;
+	// same low bits, so the same bucket
+	const uint64_t h[5] = { 7, 7 + nBuckets, 7 + 2 * nBuckets, 7 + 3 * nBuckets, 7 + 4 * nBuckets };
+	const uint16_t depth[4] = { 6, 2, 9, 4 };
+	for (size_t i = 0; i < 4; i++) tt.store(h[i], entry(static_cast<float>(i), depth[i]));
+
+	tt.store(h[4], entry(4.0f, 1));
+	TTEntry out;
+	CHECK(tt.probe(h[4], out));
+	CHECK(!tt.probe(h[1], out));	// depth 2 went
+	CHECK(tt.probe(h[0], out));
+	CHECK(tt.probe(h[2], out));
+	CHECK(tt.probe(h[3], out));
+
+	tt.store(h[1], entry(1.0f, 5));	// now h[4], at depth 1, is the shallowest
+	CHECK(tt.probe(h[1], out));
+	CHECK(!tt.probe(h[4], out));
+	CHECK(tt.probe(h[3], out));
+}
+
+int main() {
+	incrementalHashMatchesRehash();
+	hashIsStateOnly();
+	probeReturnsStored();
+	sameStateOverwrites();
+	fullBucketReplacesShallowest();
+	return testResult();
+}
@@ -0,0 +1,70 @@
+// Offline packer for animation frames: reads 24-bit BMPs (in frame order) and writes
+// one SpriteAtlas file, e.g. the landing screen snake that Snake.rc embeds as RCDATA:
+//
+//   PackSprites Snake/TitleSnake/title.snkatlas Snake/TitleSnake/s1.bmp ... s13.bmp
+
+#include "SpriteAtlas.h"
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		std::fprintf(stderr, "usage: %s <out.snkatlas> <frame.bmp>...\n", argv[0]);
+		return 2;
+	}
+
+	std::vector<SpriteImage> frames(static_cast<size_t>(argc - 2));
+	size_t rawBytes = 0;
+	for (int i = 2; i < argc; i++) {
+		SpriteImage& img = frames[static_cast<size_t>(i - 2)];
+		if (!SpriteImage::loadBmp(argv[i], img)) {
+			std::fprintf(stderr, "%s: not an uncompressed 24-bit BMP\n", argv[i]);
+			return 1;
+		}
+		rawBytes += img.bgr.size();
+	}
+
+	std::vector<uint8_t> atlas;
+	if (!SpriteAtlas::encode(frames, atlas)) {
+		std::fprintf(stderr, "frames differ in size or use more than 256 colours\n");
+		return 1;
+	}
+
+	// round trip before writing anything
+	SpriteAtlas check;
+	std::vector<uint8_t> surface;
+	if (check.open(atlas.data(), atlas.size())) {
+		size_t stride = SpriteAtlas::surfaceStride(check.frameWidth());
+		surface.resize(stride * static_cast<size_t>(check.frameHeight()) * static_cast<size_t>(check.frameCount()));
+		check.setSurface(surface.data(), stride);
+	}
+	if (!check.decodeUpTo(check.frameCount() - 1)) {
+		std::fprintf(stderr, "internal error: the atlas does not decode\n");
+		return 1;
+	}
+	const uint8_t* pal = check.palette();
+	for (int f = 0; f < check.frameCount(); f++) {
+		const SpriteImage& img = frames[static_cast<size_t>(f)];
+		for (int y = 0; y < img.height; y++) {
+			for (int x = 0; x < img.width; x++) {
+				const uint8_t* c = pal + 4 * surface[static_cast<size_t>(check.frameTop(f) + y) * SpriteAtlas::surfaceStride(img.width) + x];
+				const uint8_t* e = &img.bgr[(static_cast<size_t>(y) * img.width + x) * 3];
+				if (c[0] != e[0] || c[1] != e[1] || c[2] != e[2]) {
+					std::fprintf(stderr, "internal error: frame %d differs at (%d, %d)\n", f, x, y);
+					return 1;
+				}
+			}
+		}
+	}
+
+	std::ofstream out(argv[1], std::ios::binary);
+	out.write(reinterpret_cast<const char*>(atlas.data()), static_cast<std::streamsize>(atlas.size()));
+	if (!out) {
+		std::fprintf(stderr, "%s: write failed\n", argv[1]);
+		return 1;
+	}
+	std::printf("%d frames %dx%d, %d colours: %zu bytes of pixels -> %zu bytes\n",
+		check.frameCount(), check.frameWidth(), check.frameHeight(), check.paletteSize(), rawBytes, atlas.size());
+	return 0;
+}